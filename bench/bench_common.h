@@ -0,0 +1,46 @@
+#pragma once
+#include "shared_data.h"
+#include "shm_segment.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+
+// Collision CSV line shaped like clients/client*_data.txt; `i` makes it unique.
+inline std::string synthetic_line(long i)
+{
+  return "09/11/2021,2:39,BROOKLYN,11208,40.6672,-73.8665," + std::to_string(i) +
+         ",0,0,0,0,0,2,0,Aggressive Driving/Road Rage,Unspecified,Sedan,Unknown";
+}
+
+// An empty node region with a default-sized SeenSet in anonymous memory,
+// laid out exactly like a region of the segment the servers map (it is too
+// large for the stack and sparse in practice).
+class SharedDataMapping
+{
+public:
+  SharedDataMapping() : bytes_(region_bytes(ShmRegionOptions()))
+  {
+    void *memory = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+      perror("mmap");
+      exit(1);
+    }
+    data_ = init_region(memory, ShmRegionOptions()); // mmap already zeroed it
+  }
+
+  ~SharedDataMapping() { munmap(data_, bytes_); }
+
+  SharedDataMapping(const SharedDataMapping &) = delete;
+  SharedDataMapping &operator=(const SharedDataMapping &) = delete;
+
+  SharedData &operator*() const { return *data_; }
+  SharedData *operator->() const { return data_; }
+
+private:
+  size_t bytes_;
+  SharedData *data_;
+};
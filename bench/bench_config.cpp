@@ -0,0 +1,18 @@
+// routing.json parsing, done once per process start but also by every tool.
+#include "config_loader.h"
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+  const std::string kRoutingJson = MINI2_SOURCE_DIR "/routing.json";
+
+  void BM_LoadConfig(benchmark::State &state, const char *node)
+  {
+    for (auto _ : state)
+      benchmark::DoNotOptimize(load_config(kRoutingJson, node));
+  }
+  BENCHMARK_CAPTURE(BM_LoadConfig, A, "A");
+  BENCHMARK_CAPTURE(BM_LoadConfig, B, "B");
+  BENCHMARK_CAPTURE(BM_LoadConfig, E, "E");
+}
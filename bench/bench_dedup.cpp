@@ -0,0 +1,110 @@
+// Dedup against one node's SeenSet at increasing fill levels. range(0) is the
+// number of records inserted first; past SEEN_INDEX_BUCKETS / 2 generations
+// start to close, and past 2 * SEEN_INDEX_BUCKETS the oldest are retired.
+#include "bench_common.h"
+#include "dedup.h"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace
+{
+  void fill(SeenSet &seen, long records)
+  {
+    for (long i = 0; i < records; ++i)
+      mark_processed(seen, synthetic_line(i));
+  }
+
+  void fill_levels(benchmark::internal::Benchmark *bench)
+  {
+    for (long records : {0L, 1000L, 100000L, 500000L, 2000000L})
+      bench->Arg(records);
+  }
+
+  // Lookups of payloads that are present (the duplicate path at E and F),
+  // drawn from the most recent 100k records so they are still in the window.
+  void BM_IsDuplicateHit(benchmark::State &state)
+  {
+    SharedDataMapping shared;
+    long records = std::max(1L, static_cast<long>(state.range(0)));
+    fill(*shared->seen_set(), records);
+
+    long recent = std::min(records, 100000L);
+    std::vector<std::string> probes;
+    for (long i = 0; i < 4096; ++i)
+      probes.push_back(synthetic_line(records - 1 - i * 7919 % recent));
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(is_duplicate(*shared->seen_set(), probes[next]));
+      next = (next + 1) & 4095;
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_IsDuplicateHit)->Apply(fill_levels);
+
+  // Lookups of payloads that are absent: the probe runs to an empty bucket.
+  void BM_IsDuplicateMiss(benchmark::State &state)
+  {
+    SharedDataMapping shared;
+    long records = state.range(0);
+    fill(*shared->seen_set(), records);
+
+    std::vector<std::string> probes;
+    for (long i = 0; i < 4096; ++i)
+      probes.push_back(synthetic_line(records + i));
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(is_duplicate(*shared->seen_set(), probes[next]));
+      next = (next + 1) & 4095;
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_IsDuplicateMiss)->Apply(fill_levels);
+
+  // Inserts of new payloads. The iteration count is fixed so the set grows by
+  // at most 2% of its buckets and the fill level holds across runs.
+  void BM_MarkProcessedNew(benchmark::State &state)
+  {
+    SharedDataMapping shared;
+    long records = state.range(0);
+    fill(*shared->seen_set(), records);
+
+    const long kInserts = SEEN_INDEX_BUCKETS / 50;
+    std::vector<std::string> payloads;
+    payloads.reserve(kInserts);
+    for (long i = 0; i < kInserts; ++i)
+      payloads.push_back(synthetic_line(records + i));
+
+    size_t next = 0;
+    for (auto _ : state)
+      benchmark::DoNotOptimize(mark_processed(*shared->seen_set(), payloads[next++]));
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_MarkProcessedNew)->Apply(fill_levels)->Iterations(SEEN_INDEX_BUCKETS / 50);
+
+  // Check-and-mark of payloads that are already present.
+  void BM_MarkProcessedDuplicate(benchmark::State &state)
+  {
+    SharedDataMapping shared;
+    long records = std::max(1L, static_cast<long>(state.range(0)));
+    fill(*shared->seen_set(), records);
+
+    long recent = std::min(records, 100000L);
+    std::vector<std::string> probes;
+    for (long i = 0; i < 4096; ++i)
+      probes.push_back(synthetic_line(records - 1 - i * 7919 % recent));
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(mark_processed(*shared->seen_set(), probes[next]));
+      next = (next + 1) & 4095;
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_MarkProcessedDuplicate)->Apply(fill_levels);
+}
@@ -0,0 +1,88 @@
+// Next-hop selection over the shared load table, as run per record by C/D.
+#include "bench_common.h"
+#include "load_table.h"
+
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <cstring>
+
+namespace
+{
+  // Registers range(0) neighbors with uneven counts.
+  void register_neighbors(SharedData &data, int neighbors)
+  {
+    for (int i = 0; i < neighbors; ++i)
+    {
+      std::string name(1, static_cast<char>('C' + i));
+      strncpy(data.loads[i].name, name.c_str(), MAX_NAME_LEN - 1);
+      data.loads[i].load_count.store(1000 * (i + 1));
+    }
+    data.num_neighbors.store(neighbors);
+  }
+
+  void BM_SelectLeastLoaded(benchmark::State &state)
+  {
+    SharedDataMapping shared;
+    register_neighbors(*shared, state.range(0));
+    for (auto _ : state)
+      benchmark::DoNotOptimize(select_least_loaded(*shared));
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_SelectLeastLoaded)->DenseRange(2, MAX_NEIGHBORS, 2);
+
+  // The batch path: selection biased by records already assigned in the batch.
+  void BM_SelectLeastLoadedPending(benchmark::State &state)
+  {
+    SharedDataMapping shared;
+    register_neighbors(*shared, state.range(0));
+    int pending[MAX_NEIGHBORS] = {0};
+    for (auto _ : state)
+    {
+      int slot = select_least_loaded(*shared, pending);
+      pending[slot] = (pending[slot] + 1) & 63;
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_SelectLeastLoadedPending)->DenseRange(2, MAX_NEIGHBORS, 2);
+
+  void BM_SelectRoundRobin(benchmark::State &state)
+  {
+    SharedDataMapping shared;
+    register_neighbors(*shared, state.range(0));
+    std::atomic<unsigned> cursor{0};
+    for (auto _ : state)
+      benchmark::DoNotOptimize(select_round_robin(*shared, cursor));
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_SelectRoundRobin)->DenseRange(2, MAX_NEIGHBORS, 2);
+
+  // Sampling plus scoring; outstanding stays flat as each pick is acked.
+  void BM_SelectP2C(benchmark::State &state)
+  {
+    SharedDataMapping shared;
+    register_neighbors(*shared, state.range(0));
+    uint64_t random = 0x9e3779b97f4a7c15ULL;
+    for (auto _ : state)
+    {
+      random ^= random << 13;
+      random ^= random >> 7;
+      random ^= random << 17;
+      int slot = select_p2c(*shared, random);
+      begin_requests(*shared, slot, 1);
+      end_requests(*shared, slot, 1, std::chrono::microseconds(200 + 100 * slot), true);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_SelectP2C)->DenseRange(2, MAX_NEIGHBORS, 2);
+
+  // Per-ack bookkeeping for an already registered neighbor.
+  void BM_AddLoad(benchmark::State &state)
+  {
+    SharedDataMapping shared;
+    register_neighbors(*shared, 2);
+    for (auto _ : state)
+      add_load(*shared, "D", 1);
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_AddLoad);
+}
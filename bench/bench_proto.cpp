@@ -0,0 +1,71 @@
+// DataRequest encode/decode at collision-record sizes, in both the raw CSV
+// form and the typed form node A forwards.
+#include "bench_common.h"
+#include "collision_record.h"
+#include "data.pb.h"
+
+#include <benchmark/benchmark.h>
+
+using dataservice::DataRequest;
+
+namespace
+{
+  // range(0): 0 = CSV string payload, 1 = typed CollisionRecord.
+  DataRequest make_request(bool typed)
+  {
+    DataRequest request;
+    request.set_payload(synthetic_line(123456));
+    if (typed)
+      make_typed(request);
+    return request;
+  }
+
+  void BM_SerializeRequest(benchmark::State &state)
+  {
+    DataRequest request = make_request(state.range(0));
+    std::string bytes;
+    for (auto _ : state)
+    {
+      bytes.clear();
+      request.AppendToString(&bytes);
+      benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+  }
+  BENCHMARK(BM_SerializeRequest)->ArgName("typed")->Arg(0)->Arg(1);
+
+  void BM_ParseRequest(benchmark::State &state)
+  {
+    std::string bytes = make_request(state.range(0)).SerializeAsString();
+    DataRequest request;
+    for (auto _ : state)
+    {
+      request.ParseFromArray(bytes.data(), static_cast<int>(bytes.size()));
+      benchmark::DoNotOptimize(request);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+  }
+  BENCHMARK(BM_ParseRequest)->ArgName("typed")->Arg(0)->Arg(1);
+
+  // CSV -> typed conversion done once at node A.
+  void BM_MakeTyped(benchmark::State &state)
+  {
+    DataRequest raw = make_request(false);
+    for (auto _ : state)
+    {
+      DataRequest request = raw;
+      make_typed(request);
+      benchmark::DoNotOptimize(request);
+    }
+  }
+  BENCHMARK(BM_MakeTyped);
+
+  // typed -> CSV text done at every receiver for dedup and storage.
+  void BM_PayloadText(benchmark::State &state)
+  {
+    DataRequest request = make_request(state.range(0));
+    for (auto _ : state)
+      benchmark::DoNotOptimize(payload_text(request));
+  }
+  BENCHMARK(BM_PayloadText)->ArgName("typed")->Arg(0)->Arg(1);
+}
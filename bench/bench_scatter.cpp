@@ -0,0 +1,41 @@
+// Node B's hand-off in scatter_payload: serialize, pick a worker, push into
+// its shared-memory ring. The workers run for real (forked, parsing every
+// record) but have no neighbors, so a full ring shows up as producer stalls.
+#include "bench_common.h"
+#include "collision_record.h"
+#include "logger.h"
+#include "scatter.h"
+
+#include <benchmark/benchmark.h>
+
+using dataservice::DataRequest;
+
+// scatter.cpp reports forwarded load through these; nothing is forwarded here.
+SharedData *shared_data = nullptr;
+
+namespace
+{
+  void BM_ScatterPayload(benchmark::State &state)
+  {
+    LoggingOptions quiet;
+    quiet.level = LogLevel::Warn;
+    configure_logging(quiet);
+
+    RoutingConfig config;
+    config.node_name = "B";
+    config.scatter.mode = ScatterMode::Processes;
+    config.scatter.workers = state.range(0);
+    init_workers(config, nullptr);
+
+    DataRequest request;
+    request.set_payload(synthetic_line(42));
+    make_typed(request);
+
+    for (auto _ : state)
+      scatter_payload(request);
+    state.SetItemsProcessed(state.iterations());
+
+    shutdown_workers();
+  }
+  BENCHMARK(BM_ScatterPayload)->ArgName("workers")->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+}
@@ -10,17 +10,21 @@ def load_port_from_config():
         address = config['address_map']['A']  # Correct path
         return address.split(':')[-1]  # Extract port (e.g., '50057')
 
-def send_chunk_from_file(filename, stub):
+def read_records(filename):
     with open(filename, 'r') as f:
         for line in f:
             payload = line.strip()
             if not payload:
                 continue
-            request = DataRequest(payload=payload)
-            try:
-                response = stub.SendData(request)
-            except grpc.RpcError as e:
-                print(f"❌ Error sending payload: {e.details()}")
+            yield DataRequest(payload=payload)
+
+def send_chunk_from_file(filename, stub):
+    # One long-lived StreamData call per file instead of an RPC per line.
+    try:
+        summary = stub.StreamData(read_records(filename))
+        print(f"📥 {filename}: {summary.accepted} accepted, {summary.rejected} rejected")
+    except grpc.RpcError as e:
+        print(f"❌ Error streaming {filename}: {e.details()}")
 
 def main():
     filenames = [
@@ -24,17 +24,33 @@ _sym_db = _symbol_database.Default()
 
 
 
-DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\ndata.proto\x12\x0b\x64\x61taservice\"\x1e\n\x0b\x44\x61taRequest\x12\x0f\n\x07payload\x18\x01 \x01(\t\"\x07\n\x05\x45mpty2G\n\x0b\x44\x61taService\x12\x38\n\x08SendData\x12\x18.dataservice.DataRequest\x1a\x12.dataservice.Emptyb\x06proto3')
+DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\ndata.proto\x12\x0b\x64\x61taservice\"L\n\x0b\x44\x61taRequest\x12\x0f\n\x07payload\x18\x01 \x01(\t\x12,\n\x06record\x18\x02 \x01(\x0b\x32\x1c.dataservice.CollisionRecord\"\xf0\x01\n\x0f\x43ollisionRecord\x12\x0c\n\x04\x64\x61te\x18\x01 \x01(\r\x12\x0c\n\x04time\x18\x02 \x01(\r\x12%\n\x07\x62orough\x18\x03 \x01(\x0e\x32\x14.dataservice.Borough\x12\x0b\n\x03zip\x18\x04 \x01(\r\x12\x13\n\x0blatitude_e4\x18\x05 \x01(\x11\x12\x14\n\x0clongitude_e4\x18\x06 \x01(\x11\x12\x0e\n\x06\x63ounts\x18\x07 \x03(\r\x12\x12\n\nfactor_ids\x18\x08 \x03(\r\x12\x13\n\x0b\x66\x61\x63tor_text\x18\t \x03(\t\x12\x13\n\x0bvehicle_ids\x18\n \x03(\r\x12\x14\n\x0cvehicle_text\x18\x0b \x03(\t\"6\n\tDataBatch\x12)\n\x07records\x18\x01 \x03(\x0b\x32\x18.dataservice.DataRequest\"\x07\n\x05\x45mpty\"3\n\rIngestSummary\x12\x10\n\x08\x61\x63\x63\x65pted\x18\x01 \x01(\x04\x12\x10\n\x08rejected\x18\x02 \x01(\x04\"D\n\rNeighborStats\x12\x10\n\x08neighbor\x18\x01 \x01(\t\x12\x11\n\tforwarded\x18\x02 \x01(\x04\x12\x0e\n\x06\x66\x61iled\x18\x03 \x01(\x04\")\n\nQueueDepth\x12\x0c\n\x04name\x18\x01 \x01(\t\x12\r\n\x05\x64\x65pth\x18\x02 \x01(\x03\"a\n\x0eLatencySummary\x12\x0f\n\x07samples\x18\x01 \x01(\x04\x12\x0e\n\x06p50_us\x18\x02 \x01(\x04\x12\x0e\n\x06p90_us\x18\x03 \x01(\x04\x12\x0e\n\x06p99_us\x18\x04 \x01(\x04\x12\x0e\n\x06max_us\x18\x05 \x01(\x04\"\x8e\x02\n\tNodeStats\x12\x0c\n\x04node\x18\x01 \x01(\t\x12\x11\n\tuptime_ms\x18\x02 \x01(\x04\x12\x10\n\x08received\x18\x03 \x01(\x04\x12\x11\n\tprocessed\x18\x04 \x01(\x04\x12\x12\n\nduplicates\x18\x05 \x01(\x04\x12\x11\n\tforwarded\x18\x06 \x01(\x04\x12\x0e\n\x06\x66\x61iled\x18\x07 \x01(\x04\x12-\n\tneighbors\x18\x08 \x03(\x0b\x32\x1a.dataservice.NeighborStats\x12\'\n\x06queues\x18\t \x03(\x0b\x32\x17.dataservice.QueueDepth\x12,\n\x07latency\x18\n \x01(\x0b\x32\x1b.dataservice.LatencySummary*e\n\x07\x42orough\x12\x13\n\x0fUNKNOWN_BOROUGH\x10\x00\x12\t\n\x05\x42RONX\x10\x01\x12\x0c\n\x08\x42ROOKLYN\x10\x02\x12\r\n\tMANHATTAN\x10\x03\x12\n\n\x06QUEENS\x10\x04\x12\x11\n\rSTATEN_ISLAND\x10\x05\x32\xfe\x01\n\x0b\x44\x61taService\x12\x38\n\x08SendData\x12\x18.dataservice.DataRequest\x1a\x12.dataservice.Empty\x12\x44\n\nStreamData\x12\x18.dataservice.DataRequest\x1a\x1a.dataservice.IngestSummary(\x01\x12\x37\n\tSendBatch\x12\x16.dataservice.DataBatch\x1a\x12.dataservice.Empty\x12\x36\n\x08GetStats\x12\x12.dataservice.Empty\x1a\x16.dataservice.NodeStatsb\x06proto3')
 
 _globals = globals()
 _builder.BuildMessageAndEnumDescriptors(DESCRIPTOR, _globals)
 _builder.BuildTopDescriptorsAndMessages(DESCRIPTOR, 'data_pb2', _globals)
 if not _descriptor._USE_C_DESCRIPTORS:
   DESCRIPTOR._loaded_options = None
+  _globals['_BOROUGH']._serialized_start=951
+  _globals['_BOROUGH']._serialized_end=1052
   _globals['_DATAREQUEST']._serialized_start=27
-  _globals['_DATAREQUEST']._serialized_end=57
-  _globals['_EMPTY']._serialized_start=59
-  _globals['_EMPTY']._serialized_end=66
-  _globals['_DATASERVICE']._serialized_start=68
-  _globals['_DATASERVICE']._serialized_end=139
+  _globals['_DATAREQUEST']._serialized_end=103
+  _globals['_COLLISIONRECORD']._serialized_start=106
+  _globals['_COLLISIONRECORD']._serialized_end=346
+  _globals['_DATABATCH']._serialized_start=348
+  _globals['_DATABATCH']._serialized_end=402
+  _globals['_EMPTY']._serialized_start=404
+  _globals['_EMPTY']._serialized_end=411
+  _globals['_INGESTSUMMARY']._serialized_start=413
+  _globals['_INGESTSUMMARY']._serialized_end=464
+  _globals['_NEIGHBORSTATS']._serialized_start=466
+  _globals['_NEIGHBORSTATS']._serialized_end=534
+  _globals['_QUEUEDEPTH']._serialized_start=536
+  _globals['_QUEUEDEPTH']._serialized_end=577
+  _globals['_LATENCYSUMMARY']._serialized_start=579
+  _globals['_LATENCYSUMMARY']._serialized_end=676
+  _globals['_NODESTATS']._serialized_start=679
+  _globals['_NODESTATS']._serialized_end=949
+  _globals['_DATASERVICE']._serialized_start=1055
+  _globals['_DATASERVICE']._serialized_end=1309
 # @@protoc_insertion_point(module_scope)
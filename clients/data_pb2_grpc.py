@@ -39,6 +39,21 @@ class DataServiceStub(object):
                 request_serializer=data__pb2.DataRequest.SerializeToString,
                 response_deserializer=data__pb2.Empty.FromString,
                 _registered_method=True)
+        self.StreamData = channel.stream_unary(
+                '/dataservice.DataService/StreamData',
+                request_serializer=data__pb2.DataRequest.SerializeToString,
+                response_deserializer=data__pb2.IngestSummary.FromString,
+                _registered_method=True)
+        self.SendBatch = channel.unary_unary(
+                '/dataservice.DataService/SendBatch',
+                request_serializer=data__pb2.DataBatch.SerializeToString,
+                response_deserializer=data__pb2.Empty.FromString,
+                _registered_method=True)
+        self.GetStats = channel.unary_unary(
+                '/dataservice.DataService/GetStats',
+                request_serializer=data__pb2.Empty.SerializeToString,
+                response_deserializer=data__pb2.NodeStats.FromString,
+                _registered_method=True)
 
 
 class DataServiceServicer(object):
@@ -50,6 +65,27 @@ class DataServiceServicer(object):
         context.set_details('Method not implemented!')
         raise NotImplementedError('Method not implemented!')
 
+    def StreamData(self, request_iterator, context):
+        """Long-lived ingest stream from a client into node A.
+        """
+        context.set_code(grpc.StatusCode.UNIMPLEMENTED)
+        context.set_details('Method not implemented!')
+        raise NotImplementedError('Method not implemented!')
+
+    def SendBatch(self, request, context):
+        """Inter-node hop carrying many records in one RPC.
+        """
+        context.set_code(grpc.StatusCode.UNIMPLEMENTED)
+        context.set_details('Method not implemented!')
+        raise NotImplementedError('Method not implemented!')
+
+    def GetStats(self, request, context):
+        """Live counters for monitoring (see tools/stats_cli.cpp).
+        """
+        context.set_code(grpc.StatusCode.UNIMPLEMENTED)
+        context.set_details('Method not implemented!')
+        raise NotImplementedError('Method not implemented!')
+
 
 def add_DataServiceServicer_to_server(servicer, server):
     rpc_method_handlers = {
@@ -58,6 +94,21 @@ def add_DataServiceServicer_to_server(servicer, server):
                     request_deserializer=data__pb2.DataRequest.FromString,
                     response_serializer=data__pb2.Empty.SerializeToString,
             ),
+            'StreamData': grpc.stream_unary_rpc_method_handler(
+                    servicer.StreamData,
+                    request_deserializer=data__pb2.DataRequest.FromString,
+                    response_serializer=data__pb2.IngestSummary.SerializeToString,
+            ),
+            'SendBatch': grpc.unary_unary_rpc_method_handler(
+                    servicer.SendBatch,
+                    request_deserializer=data__pb2.DataBatch.FromString,
+                    response_serializer=data__pb2.Empty.SerializeToString,
+            ),
+            'GetStats': grpc.unary_unary_rpc_method_handler(
+                    servicer.GetStats,
+                    request_deserializer=data__pb2.Empty.FromString,
+                    response_serializer=data__pb2.NodeStats.SerializeToString,
+            ),
     }
     generic_handler = grpc.method_handlers_generic_handler(
             'dataservice.DataService', rpc_method_handlers)
@@ -95,3 +146,84 @@ class DataService(object):
             timeout,
             metadata,
             _registered_method=True)
+
+    @staticmethod
+    def StreamData(request_iterator,
+            target,
+            options=(),
+            channel_credentials=None,
+            call_credentials=None,
+            insecure=False,
+            compression=None,
+            wait_for_ready=None,
+            timeout=None,
+            metadata=None):
+        return grpc.experimental.stream_unary(
+            request_iterator,
+            target,
+            '/dataservice.DataService/StreamData',
+            data__pb2.DataRequest.SerializeToString,
+            data__pb2.IngestSummary.FromString,
+            options,
+            channel_credentials,
+            insecure,
+            call_credentials,
+            compression,
+            wait_for_ready,
+            timeout,
+            metadata,
+            _registered_method=True)
+
+    @staticmethod
+    def SendBatch(request,
+            target,
+            options=(),
+            channel_credentials=None,
+            call_credentials=None,
+            insecure=False,
+            compression=None,
+            wait_for_ready=None,
+            timeout=None,
+            metadata=None):
+        return grpc.experimental.unary_unary(
+            request,
+            target,
+            '/dataservice.DataService/SendBatch',
+            data__pb2.DataBatch.SerializeToString,
+            data__pb2.Empty.FromString,
+            options,
+            channel_credentials,
+            insecure,
+            call_credentials,
+            compression,
+            wait_for_ready,
+            timeout,
+            metadata,
+            _registered_method=True)
+
+    @staticmethod
+    def GetStats(request,
+            target,
+            options=(),
+            channel_credentials=None,
+            call_credentials=None,
+            insecure=False,
+            compression=None,
+            wait_for_ready=None,
+            timeout=None,
+            metadata=None):
+        return grpc.experimental.unary_unary(
+            request,
+            target,
+            '/dataservice.DataService/GetStats',
+            data__pb2.Empty.SerializeToString,
+            data__pb2.NodeStats.FromString,
+            options,
+            channel_credentials,
+            insecure,
+            call_credentials,
+            compression,
+            wait_for_ready,
+            timeout,
+            metadata,
+            _registered_method=True)
@@ -0,0 +1,176 @@
+#include "appender.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+Appender::Appender(const std::string &path, const StorageOptions &options)
+    : path_(path), options_(options)
+{
+  fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (fd_ == -1)
+  {
+    perror(("open " + path).c_str());
+    exit(1);
+  }
+  last_sync_ = std::chrono::steady_clock::now();
+  writer_ = std::thread(&Appender::writer_loop, this);
+}
+
+Appender::~Appender()
+{
+  stopping_.store(true);
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    wake_cv_.notify_one();
+  }
+  writer_.join();
+  close(fd_);
+}
+
+void Appender::push(Node *node)
+{
+  Node *head = head_.load(std::memory_order_relaxed);
+  do
+  {
+    node->next = head;
+  } while (!head_.compare_exchange_weak(head, node, std::memory_order_seq_cst, std::memory_order_relaxed));
+
+  // Paired with writer_loop(), which sets writer_idle_ before re-checking head_.
+  if (writer_idle_.load(std::memory_order_seq_cst))
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    wake_cv_.notify_one();
+  }
+}
+
+void Appender::wait_done(std::atomic<bool> &done)
+{
+  std::unique_lock<std::mutex> lock(mu_);
+  done_cv_.wait(lock, [&]
+                { return done.load(std::memory_order_acquire); });
+}
+
+void Appender::append(std::string lines)
+{
+  Node *node = new Node;
+  node->lines = std::move(lines);
+  if (options_.durability != Durability::FsyncBeforeAck)
+  {
+    push(node);
+    return;
+  }
+
+  std::atomic<bool> done{false};
+  node->done = &done;
+  push(node);
+  wait_done(done);
+}
+
+void Appender::flush()
+{
+  std::atomic<bool> done{false};
+  Node *node = new Node;
+  node->done = &done;
+  push(node);
+  wait_done(done);
+}
+
+void Appender::write_all(const std::string &buffer)
+{
+  const char *data = buffer.data();
+  size_t left = buffer.size();
+  while (left > 0)
+  {
+    ssize_t written = write(fd_, data, left);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      perror(("write " + path_).c_str());
+      return;
+    }
+    data += written;
+    left -= written;
+  }
+  dirty_ = true;
+}
+
+void Appender::sync()
+{
+  if (dirty_ && fsync(fd_) == -1)
+    perror(("fsync " + path_).c_str());
+  dirty_ = false;
+  last_sync_ = std::chrono::steady_clock::now();
+}
+
+void Appender::writer_loop()
+{
+  auto interval = std::chrono::milliseconds(options_.fsync_interval_ms);
+  std::string buffer;
+  std::vector<Node *> batch;
+
+  while (true)
+  {
+    Node *list = head_.exchange(nullptr, std::memory_order_acquire);
+    if (!list)
+    {
+      if (stopping_.load())
+        break;
+
+      std::unique_lock<std::mutex> lock(mu_);
+      writer_idle_.store(true, std::memory_order_seq_cst);
+      if (!head_.load(std::memory_order_seq_cst) && !stopping_.load())
+      {
+        if (options_.durability == Durability::Periodic && dirty_)
+          wake_cv_.wait_until(lock, last_sync_ + interval);
+        else
+          wake_cv_.wait(lock);
+      }
+      writer_idle_.store(false, std::memory_order_relaxed);
+      lock.unlock();
+
+      if (options_.durability == Durability::Periodic && dirty_ &&
+          std::chrono::steady_clock::now() >= last_sync_ + interval)
+        sync();
+      continue;
+    }
+
+    // The list is newest-first; restore arrival order.
+    batch.clear();
+    for (Node *node = list; node; node = node->next)
+      batch.push_back(node);
+
+    buffer.clear();
+    bool waiters = false;
+    for (auto it = batch.rbegin(); it != batch.rend(); ++it)
+    {
+      buffer += (*it)->lines;
+      waiters = waiters || (*it)->done;
+    }
+    write_all(buffer);
+
+    if (waiters || (options_.durability == Durability::Periodic &&
+                    std::chrono::steady_clock::now() >= last_sync_ + interval))
+      sync();
+
+    if (waiters)
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      for (Node *node : batch)
+      {
+        if (node->done)
+          node->done->store(true, std::memory_order_release);
+      }
+      done_cv_.notify_all();
+    }
+    for (Node *node : batch)
+      delete node;
+  }
+
+  if (options_.durability != Durability::None)
+    sync();
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "config_loader.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Keeps one log file open and appends to it from a dedicated writer thread.
+// Handler threads push onto a lock-free list; the writer takes everything
+// queued so far and issues it as one write() (and one fsync, depending on
+// durability), so concurrent records share a single group commit.
+class Appender
+{
+public:
+  Appender(const std::string &path, const StorageOptions &options);
+  ~Appender(); // writes everything queued, syncs, closes
+
+  // Queues `lines` (each ending in '\n'). With Durability::FsyncBeforeAck this
+  // returns only once the lines are on disk.
+  void append(std::string lines);
+
+  // Blocks until everything queued so far is written and synced.
+  void flush();
+
+private:
+  struct Node
+  {
+    std::string lines;
+    Node *next = nullptr;
+    std::atomic<bool> *done = nullptr; // set by the writer when the caller waits
+  };
+
+  void push(Node *node);
+  void wait_done(std::atomic<bool> &done);
+  void writer_loop();
+  void write_all(const std::string &buffer);
+  void sync();
+
+  int fd_;
+  std::string path_;
+  StorageOptions options_;
+
+  std::atomic<Node *> head_{nullptr};
+  std::atomic<bool> writer_idle_{false};
+  std::atomic<bool> stopping_{false};
+
+  std::mutex mu_;
+  std::condition_variable wake_cv_; // writer sleeps here
+  std::condition_variable done_cv_; // waiting appenders sleep here
+
+  bool dirty_ = false; // written since the last fsync (writer thread only)
+  std::chrono::steady_clock::time_point last_sync_;
+  std::thread writer_;
+};
@@ -0,0 +1,203 @@
+#include "batcher.h"
+#include "logger.h"
+
+#include <iostream>
+
+using dataservice::DataBatch;
+using dataservice::DataRequest;
+using dataservice::DataService;
+using dataservice::Empty;
+
+namespace
+{
+  struct BatchCall
+  {
+    grpc::ClientContext context;
+    DataBatch batch;
+    std::vector<BatchForwarder::RecordDone> done;
+    Empty response;
+    std::chrono::steady_clock::time_point sent;
+  };
+}
+
+BatchForwarder::BatchForwarder(ChannelRegistry &channels, const std::vector<std::string> &neighbors,
+                               const BatchOptions &options, BatchDone on_batch, EdgeCredits *credits,
+                               SeenSummary *summary)
+    : channels_(channels), options_(options), on_batch_(std::move(on_batch)), credits_(credits), summary_(summary)
+{
+  for (const auto &neighbor : neighbors)
+  {
+    lanes_[neighbor] = std::make_unique<Lane>();
+  }
+  linger_thread_ = std::thread(&BatchForwarder::linger_loop, this);
+}
+
+BatchForwarder::~BatchForwarder()
+{
+  {
+    std::lock_guard<std::mutex> lock(state_mu_);
+    stopping_ = true;
+  }
+  state_cv_.notify_all();
+  linger_thread_.join();
+
+  flush();
+
+  std::unique_lock<std::mutex> lock(state_mu_);
+  state_cv_.wait(lock, [this]
+                 { return in_flight_ == 0; });
+}
+
+void BatchForwarder::add(const std::string &neighbor, const DataRequest &record, RecordDone done,
+                         const TraceContext *trace)
+{
+  auto it = lanes_.find(neighbor);
+  if (it == lanes_.end())
+  {
+    if (done)
+      done(grpc::Status(grpc::StatusCode::NOT_FOUND, "unknown neighbor " + neighbor));
+    return;
+  }
+
+  Pending full;
+  {
+    Lane &lane = *it->second;
+    std::lock_guard<std::mutex> lock(lane.mu);
+    if (lane.pending.batch.records_size() == 0)
+    {
+      lane.pending.opened = std::chrono::steady_clock::now();
+    }
+    if (trace)
+      lane.pending.traces.emplace_back(lane.pending.batch.records_size(), *trace);
+    *lane.pending.batch.add_records() = record;
+    lane.pending.done.push_back(std::move(done));
+
+    if (lane.pending.batch.records_size() < options_.max_records)
+      return;
+    full = std::move(lane.pending);
+    lane.pending = Pending();
+  }
+  send(neighbor, std::move(full));
+}
+
+void BatchForwarder::flush()
+{
+  for (auto &[neighbor, lane] : lanes_)
+  {
+    Pending pending;
+    {
+      std::lock_guard<std::mutex> lock(lane->mu);
+      if (lane->pending.batch.records_size() == 0)
+        continue;
+      pending = std::move(lane->pending);
+      lane->pending = Pending();
+    }
+    send(neighbor, std::move(pending));
+  }
+}
+
+int BatchForwarder::buffered()
+{
+  int records = 0;
+  for (auto &[neighbor, lane] : lanes_)
+  {
+    std::lock_guard<std::mutex> lock(lane->mu);
+    records += lane->pending.batch.records_size();
+  }
+  return records;
+}
+
+int BatchForwarder::in_flight()
+{
+  std::lock_guard<std::mutex> lock(state_mu_);
+  return in_flight_;
+}
+
+void BatchForwarder::send(const std::string &neighbor, Pending pending)
+{
+  DataService::Stub *stub = channels_.stub(neighbor);
+  if (!stub)
+  {
+    grpc::Status status(grpc::StatusCode::UNAVAILABLE, "no channel to " + neighbor);
+    if (credits_)
+      credits_->release(neighbor, pending.batch.records_size(), nullptr);
+    if (on_batch_)
+      on_batch_(neighbor, pending.batch.records_size(), status, std::chrono::microseconds(0));
+    for (auto &done : pending.done)
+      if (done)
+        done(status);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(state_mu_);
+    in_flight_++;
+  }
+
+  auto *call = new BatchCall;
+  call->batch = std::move(pending.batch);
+  call->done = std::move(pending.done);
+  for (auto &[index, trace] : pending.traces)
+    trace.depart();
+  attach_traces(call->context, pending.traces);
+  channels_.set_deadline(call->context, neighbor);
+  call->sent = std::chrono::steady_clock::now();
+
+  stub->async()->SendBatch(&call->context, &call->batch, &call->response,
+                           [this, call, neighbor](grpc::Status status)
+                           {
+                             if (!status.ok())
+                             {
+                               LOG_ERROR("[Batch] ❌ Failed to send " << call->batch.records_size() << " records to "
+                                                                       << neighbor << ": " << status.error_message());
+                             }
+                             if (credits_)
+                               credits_->release(neighbor, call->batch.records_size(), &call->context);
+                             if (summary_)
+                               summary_->absorb(&call->context);
+                             if (on_batch_)
+                               on_batch_(neighbor, call->batch.records_size(), status,
+                                         std::chrono::duration_cast<std::chrono::microseconds>(
+                                             std::chrono::steady_clock::now() - call->sent));
+                             for (auto &done : call->done)
+                               if (done)
+                                 done(status);
+                             delete call;
+
+                             std::lock_guard<std::mutex> lock(state_mu_);
+                             in_flight_--;
+                             state_cv_.notify_all();
+                           });
+}
+
+void BatchForwarder::linger_loop()
+{
+  const auto linger = std::chrono::milliseconds(options_.linger_ms);
+  // Check at a fraction of the linger so a batch never waits much past it.
+  const auto tick = std::max(std::chrono::milliseconds(1), linger / 2);
+
+  std::unique_lock<std::mutex> state(state_mu_);
+  while (!stopping_)
+  {
+    state_cv_.wait_for(state, tick);
+    if (stopping_)
+      break;
+    state.unlock();
+
+    auto now = std::chrono::steady_clock::now();
+    for (auto &[neighbor, lane] : lanes_)
+    {
+      Pending pending;
+      {
+        std::lock_guard<std::mutex> lock(lane->mu);
+        if (lane->pending.batch.records_size() == 0 || now - lane->pending.opened < linger)
+          continue;
+        pending = std::move(lane->pending);
+        lane->pending = Pending();
+      }
+      send(neighbor, std::move(pending));
+    }
+
+    state.lock();
+  }
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "channel_registry.h"
+#include "config_loader.h"
+#include "credits.h"
+#include "data.grpc.pb.h"
+#include "seen_summary.h"
+#include "trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Accumulates records per downstream neighbor and ships them with a single
+// SendBatch RPC once a batch holds max_records or its oldest record has
+// waited linger_ms, whichever comes first. Sends are asynchronous, so add()
+// never blocks on the network.
+class BatchForwarder
+{
+public:
+  // Called once per record when the batch carrying it completes.
+  using RecordDone = std::function<void(const grpc::Status &)>;
+  // Called once per batch, e.g. for load accounting, with the RPC's latency.
+  using BatchDone = std::function<void(const std::string &neighbor, int records, const grpc::Status &,
+                                       std::chrono::microseconds latency)>;
+
+  // With `credits`, callers take one credit per record before add(); the
+  // forwarder hands them back (with the downstream's grant) per batch.
+  // `summary` takes the fingerprints each batch's response carries back.
+  BatchForwarder(ChannelRegistry &channels, const std::vector<std::string> &neighbors,
+                 const BatchOptions &options, BatchDone on_batch = nullptr, EdgeCredits *credits = nullptr,
+                 SeenSummary *summary = nullptr);
+  ~BatchForwarder(); // flushes and waits for outstanding batches
+
+  // A sampled record's trace rides along; its hop departs when the batch is sent.
+  void add(const std::string &neighbor, const dataservice::DataRequest &record, RecordDone done = nullptr,
+           const TraceContext *trace = nullptr);
+  void flush();
+
+  int buffered();  // records waiting in open batches
+  int in_flight(); // batches sent but not yet completed
+
+private:
+  struct Pending
+  {
+    dataservice::DataBatch batch;
+    std::vector<RecordDone> done;
+    TraceSet traces;
+    std::chrono::steady_clock::time_point opened;
+  };
+
+  struct Lane
+  {
+    std::mutex mu;
+    Pending pending;
+  };
+
+  void send(const std::string &neighbor, Pending pending);
+  void linger_loop();
+
+  ChannelRegistry &channels_;
+  BatchOptions options_;
+  BatchDone on_batch_;
+  EdgeCredits *credits_;
+  SeenSummary *summary_;
+  std::unordered_map<std::string, std::unique_ptr<Lane>> lanes_;
+
+  std::mutex state_mu_;
+  std::condition_variable state_cv_;
+  bool stopping_ = false;
+  int in_flight_ = 0;
+  std::thread linger_thread_;
+};
@@ -0,0 +1,85 @@
+#include "channel_registry.h"
+#include "logger.h"
+
+#include <iostream>
+
+using dataservice::DataService;
+
+namespace
+{
+  const std::string kEmpty;
+}
+
+ChannelRegistry::ChannelRegistry(const RoutingConfig &config)
+{
+  for (const auto &neighbor : config.neighbors)
+  {
+    auto addr = config.address_map.find(neighbor);
+    if (addr == config.address_map.end())
+    {
+      LOG_WARN("[Channels] ❌ No address for neighbor " << neighbor);
+      continue;
+    }
+
+    EdgeOptions options;
+    auto edge = config.edge_options.find(neighbor);
+    if (edge != config.edge_options.end())
+    {
+      options = edge->second;
+    }
+
+    auto entry = std::make_unique<Entry>();
+    entry->address = addr->second;
+    entry->deadline = std::chrono::milliseconds(options.deadline_ms);
+
+    for (int i = 0; i < options.connections; ++i)
+    {
+      grpc::ChannelArguments args;
+      for (const auto &[key, val] : options.int_args)
+        args.SetInt(key, val);
+      for (const auto &[key, val] : options.string_args)
+        args.SetString(key, val);
+
+      // Channels with identical args share one subchannel (and one TCP
+      // connection) by default. A local pool plus a per-stripe arg forces a
+      // separate HTTP/2 connection per stripe.
+      args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+      args.SetInt("mini2.channel_stripe", i);
+
+      auto channel = grpc::CreateCustomChannel(entry->address, grpc::InsecureChannelCredentials(), args);
+      entry->stubs.push_back(DataService::NewStub(channel));
+      entry->channels.push_back(std::move(channel));
+    }
+
+    LOG_INFO("[Channels] 🔗 " << config.node_name << " -> " << neighbor << " (" << entry->address << "), " << options.connections << " connection(s)");
+    entries_[neighbor] = std::move(entry);
+  }
+}
+
+DataService::Stub *ChannelRegistry::stub(const std::string &neighbor)
+{
+  auto it = entries_.find(neighbor);
+  if (it == entries_.end())
+    return nullptr;
+
+  Entry &entry = *it->second;
+  unsigned stripe = entry.next.fetch_add(1, std::memory_order_relaxed) % entry.stubs.size();
+  return entry.stubs[stripe].get();
+}
+
+const std::string &ChannelRegistry::address(const std::string &neighbor) const
+{
+  auto it = entries_.find(neighbor);
+  return it == entries_.end() ? kEmpty : it->second->address;
+}
+
+std::chrono::milliseconds ChannelRegistry::deadline(const std::string &neighbor) const
+{
+  auto it = entries_.find(neighbor);
+  return it == entries_.end() ? std::chrono::milliseconds(EdgeOptions().deadline_ms) : it->second->deadline;
+}
+
+void ChannelRegistry::set_deadline(grpc::ClientContext &context, const std::string &neighbor) const
+{
+  context.set_deadline(std::chrono::system_clock::now() + deadline(neighbor));
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "config_loader.h"
+#include "data.grpc.pb.h"
+
+#include <grpcpp/grpcpp.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Long-lived channels and stubs to every neighbor of this node, created once
+// at startup instead of per message. Each neighbor can be striped across
+// several HTTP/2 connections; stub() rotates over them.
+class ChannelRegistry
+{
+public:
+  explicit ChannelRegistry(const RoutingConfig &config);
+
+  // Returns nullptr if the neighbor has no address in routing.json.
+  dataservice::DataService::Stub *stub(const std::string &neighbor);
+  const std::string &address(const std::string &neighbor) const;
+  // The edge's "deadline_ms" (the default for unknown neighbors).
+  std::chrono::milliseconds deadline(const std::string &neighbor) const;
+  // Bounds an outbound call to neighbor by that deadline, starting now.
+  void set_deadline(grpc::ClientContext &context, const std::string &neighbor) const;
+
+private:
+  struct Entry
+  {
+    std::string address;
+    std::chrono::milliseconds deadline{0};
+    std::vector<std::shared_ptr<grpc::Channel>> channels;
+    std::vector<std::unique_ptr<dataservice::DataService::Stub>> stubs;
+    std::atomic<unsigned> next{0};
+  };
+
+  std::unordered_map<std::string, std::unique_ptr<Entry>> entries_;
+};
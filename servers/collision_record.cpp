@@ -0,0 +1,349 @@
+#include "collision_record.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using dataservice::Borough;
+using dataservice::CollisionRecord;
+using dataservice::DataRequest;
+
+namespace
+{
+  constexpr int kCsvFields = 18;
+  constexpr int kCountFields = 8; // columns 7..14
+  constexpr int kFactorFields = 2;
+  constexpr int kVehicleFields = 2;
+
+  // Interned vocabularies, taken from the most frequent values in the
+  // collision data set. Ids are index + 1; never reorder, only append.
+  const std::vector<std::string> kFactors = {
+      "Unspecified",
+      "Driver Inattention/Distraction",
+      "Following Too Closely",
+      "Failure to Yield Right-of-Way",
+      "Passing or Lane Usage Improper",
+      "Passing Too Closely",
+      "Unsafe Speed",
+      "Traffic Control Disregarded",
+      "Other Vehicular",
+      "Backing Unsafely",
+      "Turning Improperly",
+      "Unknown",
+      "Driver Inexperience",
+      "Unsafe Lane Changing",
+      "Alcohol Involvement",
+      "Reaction to Uninvolved Vehicle",
+      "Pedestrian/Bicyclist/Other Pedestrian Error/Confusion",
+      "View Obstructed/Limited",
+      "Aggressive Driving/Road Rage",
+      "Oversized Vehicle",
+      "Fell Asleep",
+      "Pavement Slippery",
+      "Brakes Defective",
+      "Passenger Distraction",
+      "Steering Failure",
+      "Outside Car Distraction",
+      "Tire Failure/Inadequate",
+      "Obstruction/Debris",
+      "Lost Consciousness",
+      "Fatigued/Drowsy",
+      "Pavement Defective",
+      "Failure to Keep Right",
+      "Illnes",
+      "Glare",
+      "Drugs (illegal)",
+      "Animals Action",
+      "Accelerator Defective",
+      "Driverless/Runaway Vehicle",
+      "Cell Phone (hand-Held)",
+      "Using On Board Navigation Device",
+      "Tinted Windows",
+      "Physical Disability",
+      "Headlights Defective",
+      "Other Lighting Defects",
+      "Lane Marking Improper/Inadequate",
+      "Cell Phone (hands-free)",
+      "Windshield Inadequate",
+      "Vehicle Vandalism",
+      "Traffic Control Device Improper/Non-Working",
+      "Tow Hitch Defective",
+      "Other Electronic Device",
+      "Eating or Drinking",
+      "0",
+  };
+
+  const std::vector<std::string> kVehicleTypes = {
+      "Sedan",
+      "Station Wagon/Sport Utility Vehicle",
+      "Unknown",
+      "Bike",
+      "Box Truck",
+      "Taxi",
+      "Pick-up Truck",
+      "Bus",
+      "E-Bike",
+      "Motorcycle",
+      "Tractor Truck Diesel",
+      "Van",
+      "E-Scooter",
+      "Ambulance",
+      "Moped",
+      "Dump",
+      "PK",
+      "Convertible",
+      "Garbage or Refuse",
+      "Flat Bed",
+      "Tow Truck / Wrecker",
+      "Carry All",
+      "Motorbike",
+      "Motorscooter",
+      "Tractor Truck Gasoline",
+      "AMBULANCE",
+      "Tanker",
+      "Chassis Cab",
+      "4 dr sedan",
+      "Concrete Mixer",
+      "MOPED",
+      "3-Door",
+  };
+
+  const std::vector<std::pair<Borough, std::string>> kBoroughs = {
+      {dataservice::UNKNOWN_BOROUGH, "UNKNOWN_BOROUGH"},
+      {dataservice::BRONX, "BRONX"},
+      {dataservice::BROOKLYN, "BROOKLYN"},
+      {dataservice::MANHATTAN, "MANHATTAN"},
+      {dataservice::QUEENS, "QUEENS"},
+      {dataservice::STATEN_ISLAND, "STATEN ISLAND"},
+  };
+
+  uint32_t intern(const std::vector<std::string> &vocabulary, const std::string &value)
+  {
+    for (size_t i = 0; i < vocabulary.size(); ++i)
+    {
+      if (vocabulary[i] == value)
+        return static_cast<uint32_t>(i + 1);
+    }
+    return 0;
+  }
+
+  bool parse_uint(const std::string &text, uint32_t &out)
+  {
+    if (text.empty() || text.size() > 9)
+      return false;
+    uint32_t value = 0;
+    for (char c : text)
+    {
+      if (c < '0' || c > '9')
+        return false;
+      value = value * 10 + static_cast<uint32_t>(c - '0');
+    }
+    out = value;
+    return true;
+  }
+
+  // "-73.974" -> -739740. At most four decimals; the formatter trims
+  // trailing zeros, so the round-trip check rejects inputs that keep them.
+  bool parse_degrees_e4(const std::string &text, int32_t &out)
+  {
+    size_t pos = 0;
+    bool negative = !text.empty() && text[0] == '-';
+    if (negative)
+      pos = 1;
+
+    size_t dot = text.find('.', pos);
+    uint32_t whole = 0;
+    uint32_t frac = 0;
+    if (!parse_uint(text.substr(pos, dot == std::string::npos ? std::string::npos : dot - pos), whole) || whole > 180)
+      return false;
+
+    if (dot != std::string::npos)
+    {
+      std::string digits = text.substr(dot + 1);
+      if (digits.empty() || digits.size() > 4 || !parse_uint(digits, frac))
+        return false;
+      for (size_t i = digits.size(); i < 4; ++i)
+        frac *= 10;
+    }
+
+    int32_t value = static_cast<int32_t>(whole * 10000 + frac);
+    out = negative ? -value : value;
+    return true;
+  }
+
+  void append_degrees_e4(std::string &out, int32_t value)
+  {
+    if (value < 0)
+    {
+      out += '-';
+      value = -value;
+    }
+    out += std::to_string(value / 10000);
+
+    int frac = value % 10000;
+    if (frac == 0)
+      return;
+
+    char digits[8];
+    snprintf(digits, sizeof(digits), "%04d", frac);
+    std::string text(digits);
+    text.erase(text.find_last_not_of('0') + 1);
+    out += '.';
+    out += text;
+  }
+
+  void intern_all(const std::vector<std::string> &vocabulary, const std::vector<std::string> &values,
+                  google::protobuf::RepeatedField<uint32_t> *ids,
+                  google::protobuf::RepeatedPtrField<std::string> *text)
+  {
+    for (const auto &value : values)
+    {
+      uint32_t id = intern(vocabulary, value);
+      ids->Add(id);
+      if (id == 0)
+        *text->Add() = value;
+    }
+  }
+
+  void append_interned(std::string &out, const std::vector<std::string> &vocabulary,
+                       const google::protobuf::RepeatedField<uint32_t> &ids,
+                       const google::protobuf::RepeatedPtrField<std::string> &text)
+  {
+    int next_text = 0;
+    for (uint32_t id : ids)
+    {
+      out += ',';
+      if (id > 0 && id <= vocabulary.size())
+        out += vocabulary[id - 1];
+      else if (next_text < text.size())
+        out += text.Get(next_text++);
+    }
+  }
+}
+
+bool parse_collision_record(const std::string &line, CollisionRecord &record)
+{
+  std::vector<std::string> fields;
+  size_t start = 0;
+  while (true)
+  {
+    size_t comma = line.find(',', start);
+    fields.push_back(line.substr(start, comma == std::string::npos ? std::string::npos : comma - start));
+    if (comma == std::string::npos)
+      break;
+    start = comma + 1;
+  }
+  if (fields.size() != kCsvFields)
+    return false;
+
+  record.Clear();
+
+  // MM/DD/YYYY -> YYYYMMDD
+  const std::string &date = fields[0];
+  uint32_t month, day, year;
+  if (date.size() != 10 || date[2] != '/' || date[5] != '/' ||
+      !parse_uint(date.substr(0, 2), month) || !parse_uint(date.substr(3, 2), day) ||
+      !parse_uint(date.substr(6, 4), year))
+    return false;
+  record.set_date(year * 10000 + month * 100 + day);
+
+  // H:MM -> minutes after midnight
+  const std::string &time = fields[1];
+  size_t colon = time.find(':');
+  uint32_t hours, minutes;
+  if (colon == std::string::npos || !parse_uint(time.substr(0, colon), hours) ||
+      !parse_uint(time.substr(colon + 1), minutes))
+    return false;
+  record.set_time(hours * 60 + minutes);
+
+  bool borough_found = false;
+  for (const auto &[borough, name] : kBoroughs)
+  {
+    if (fields[2] == name)
+    {
+      record.set_borough(borough);
+      borough_found = true;
+      break;
+    }
+  }
+  if (!borough_found)
+    return false;
+
+  uint32_t zip;
+  int32_t latitude, longitude;
+  if (!parse_uint(fields[3], zip) || !parse_degrees_e4(fields[4], latitude) || !parse_degrees_e4(fields[5], longitude))
+    return false;
+  record.set_zip(zip);
+  record.set_latitude_e4(latitude);
+  record.set_longitude_e4(longitude);
+
+  for (int i = 0; i < kCountFields; ++i)
+  {
+    uint32_t count;
+    if (!parse_uint(fields[6 + i], count))
+      return false;
+    record.add_counts(count);
+  }
+
+  const int factors_at = 6 + kCountFields;
+  const int vehicles_at = factors_at + kFactorFields;
+  intern_all(kFactors, {fields.begin() + factors_at, fields.begin() + vehicles_at},
+             record.mutable_factor_ids(), record.mutable_factor_text());
+  intern_all(kVehicleTypes, {fields.begin() + vehicles_at, fields.begin() + vehicles_at + kVehicleFields},
+             record.mutable_vehicle_ids(), record.mutable_vehicle_text());
+
+  return format_collision_record(record) == line;
+}
+
+std::string format_collision_record(const CollisionRecord &record)
+{
+  std::string out;
+  out.reserve(128);
+
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%02u/%02u/%04u,%u:%02u,", record.date() / 100 % 100, record.date() % 100,
+           record.date() / 10000, record.time() / 60, record.time() % 60);
+  out += buf;
+
+  for (const auto &[borough, name] : kBoroughs)
+  {
+    if (record.borough() == borough)
+    {
+      out += name;
+      break;
+    }
+  }
+
+  snprintf(buf, sizeof(buf), ",%05u,", record.zip());
+  out += buf;
+  append_degrees_e4(out, record.latitude_e4());
+  out += ',';
+  append_degrees_e4(out, record.longitude_e4());
+
+  for (uint32_t count : record.counts())
+  {
+    out += ',';
+    out += std::to_string(count);
+  }
+
+  append_interned(out, kFactors, record.factor_ids(), record.factor_text());
+  append_interned(out, kVehicleTypes, record.vehicle_ids(), record.vehicle_text());
+  return out;
+}
+
+void make_typed(DataRequest &request)
+{
+  if (request.payload().empty() || request.has_record())
+    return;
+  if (parse_collision_record(request.payload(), *request.mutable_record()))
+    request.clear_payload();
+  else
+    request.clear_record();
+}
+
+std::string payload_text(const DataRequest &request)
+{
+  if (request.has_record())
+    return format_collision_record(request.record());
+  return request.payload();
+}
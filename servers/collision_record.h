@@ -0,0 +1,19 @@
+#pragma once
+#include "data.pb.h"
+
+#include <string>
+
+// Parses one collision CSV line into its typed form. Returns false when the
+// line does not round-trip byte-for-byte through format_collision_record;
+// callers then keep sending the raw string so nothing is lost.
+bool parse_collision_record(const std::string &line, dataservice::CollisionRecord &record);
+
+// Renders a typed record back to the exact CSV line it was parsed from.
+std::string format_collision_record(const dataservice::CollisionRecord &record);
+
+// Replaces a request's CSV payload with the typed record when it parses.
+void make_typed(dataservice::DataRequest &request);
+
+// The CSV line a request carries, whichever form it arrived in. Storage and
+// dedup work on this text so typed and string records compare equal.
+std::string payload_text(const dataservice::DataRequest &request);
@@ -1,9 +1,213 @@
 #include "config_loader.h"
+#include <algorithm>
 #include <fstream>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
 
+namespace
+{
+  // Overlay "connections", "deadline_ms" and "channel_args" from a JSON edge block.
+  void apply_edge_options(const json &block, EdgeOptions &options)
+  {
+    if (block.contains("connections"))
+    {
+      options.connections = std::max(1, block["connections"].get<int>());
+    }
+
+    if (block.contains("deadline_ms"))
+    {
+      options.deadline_ms = std::max(1, block["deadline_ms"].get<int>());
+    }
+
+    if (block.contains("channel_args"))
+    {
+      for (auto &[arg, val] : block["channel_args"].items())
+      {
+        if (val.is_number_integer())
+          options.int_args[arg] = val.get<int>();
+        else if (val.is_string())
+          options.string_args[arg] = val.get<std::string>();
+        else
+          throw std::runtime_error("Unsupported channel arg type: " + arg);
+      }
+    }
+  }
+
+  void apply_batch_options(const json &block, BatchOptions &options)
+  {
+    options.enabled = block.value("enabled", options.enabled);
+    options.max_records = std::max(1, block.value("max_records", options.max_records));
+    options.linger_ms = std::max(0, block.value("linger_ms", options.linger_ms));
+  }
+
+  void apply_scatter_options(const json &block, ScatterOptions &options)
+  {
+    std::string mode = block.value("mode", std::string("processes"));
+    if (mode == "processes")
+      options.mode = ScatterMode::Processes;
+    else if (mode == "threads")
+      options.mode = ScatterMode::Threads;
+    else
+      throw std::runtime_error("Unknown scatter mode: " + mode);
+
+    options.workers = std::max(0, block.value("workers", options.workers));
+
+    std::string dispatch = block.value("dispatch", std::string("roundrobin"));
+    if (dispatch == "roundrobin")
+      options.dispatch = ScatterDispatch::RoundRobin;
+    else if (dispatch == "p2c")
+      options.dispatch = ScatterDispatch::PowerOfTwo;
+    else
+      throw std::runtime_error("Unknown scatter dispatch: " + dispatch);
+  }
+
+  void apply_storage_options(const json &block, StorageOptions &options)
+  {
+    if (block.contains("durability"))
+    {
+      std::string durability = block["durability"].get<std::string>();
+      if (durability == "none")
+        options.durability = Durability::None;
+      else if (durability == "periodic")
+        options.durability = Durability::Periodic;
+      else if (durability == "fsync")
+        options.durability = Durability::FsyncBeforeAck;
+      else
+        throw std::runtime_error("Unknown durability mode: " + durability);
+    }
+    options.fsync_interval_ms = std::max(1, block.value("fsync_interval_ms", options.fsync_interval_ms));
+  }
+
+  void apply_logging_options(const json &block, LoggingOptions &options)
+  {
+    if (block.contains("level"))
+    {
+      std::string level = block["level"].get<std::string>();
+      if (level == "debug")
+        options.level = LogLevel::Debug;
+      else if (level == "info")
+        options.level = LogLevel::Info;
+      else if (level == "warn")
+        options.level = LogLevel::Warn;
+      else if (level == "error")
+        options.level = LogLevel::Error;
+      else if (level == "off")
+        options.level = LogLevel::Off;
+      else
+        throw std::runtime_error("Unknown log level: " + level);
+    }
+    options.sample_every = std::max(1, block.value("sample_every", options.sample_every));
+  }
+
+  void apply_tracing_options(const json &block, TracingOptions &options)
+  {
+    options.enabled = block.value("enabled", options.enabled);
+    options.sample_every = std::max(1, block.value("sample_every", options.sample_every));
+  }
+
+  void apply_backpressure_options(const json &block, BackpressureOptions &options)
+  {
+    options.enabled = block.value("enabled", options.enabled);
+    options.max_in_flight = std::max(1, block.value("max_in_flight", options.max_in_flight));
+    options.queue_limit = std::max(0, block.value("queue_limit", options.queue_limit));
+    options.queue_timeout_ms = std::max(0, block.value("queue_timeout_ms", options.queue_timeout_ms));
+  }
+
+  void apply_seen_summary_options(const json &block, SeenSummaryOptions &options)
+  {
+    options.enabled = block.value("enabled", options.enabled);
+    options.bloom_bits = std::max(64, block.value("bloom_bits", options.bloom_bits));
+    options.hashes = std::max(1, block.value("hashes", options.hashes));
+    options.max_false_positive = std::clamp(block.value("max_false_positive", options.max_false_positive), 1e-9, 0.5);
+    options.generations = std::max(0, block.value("generations", options.generations));
+    options.generation_records = std::max(0, block.value("generation_records", options.generation_records));
+    options.generation_ms = std::max(0, block.value("generation_ms", options.generation_ms));
+    options.max_push = std::max(1, block.value("max_push", options.max_push));
+    options.queue_limit = std::max(0, block.value("queue_limit", options.queue_limit));
+  }
+
+  void apply_region_options(const json &block, ShmRegionOptions &options)
+  {
+    options.seen_buckets = std::max(0, block.value("seen_buckets", options.seen_buckets));
+    options.arena_bytes = std::max(0, block.value("arena_bytes", options.arena_bytes));
+    options.generations = std::max(1, block.value("generations", options.generations));
+    options.window_ms = std::max(0, block.value("window_ms", options.window_ms));
+  }
+
+  // The node's "host" key, or else the host part of its address. Addresses
+  // alone cannot tell that "localhost" and a LAN address are one machine.
+  std::string host_of(const json &nodes, const RoutingConfig &config, const std::string &node)
+  {
+    if (nodes.contains(node) && nodes[node].contains("host"))
+      return nodes[node]["host"].get<std::string>();
+    auto address = config.address_map.find(node);
+    if (address == config.address_map.end())
+      return "";
+    size_t colon = address->second.rfind(':');
+    return colon == std::string::npos ? address->second : address->second.substr(0, colon);
+  }
+
+  // Unset parts of A's summary window default to the shortest window any
+  // node's SeenSet guarantees: (generations - 1) generations of
+  // seen_buckets / 2 records, each also closed after window_ms /
+  // generations. A then never drops a repeat its storing node would take
+  // as new.
+  void apply_summary_window(const json &j, SeenSummaryOptions &options)
+  {
+    int generations = 0;
+    int records = 0;
+    int generation_ms = 0;
+    for (auto &[node, block] : j["nodes"].items())
+    {
+      ShmRegionOptions region;
+      if (j.contains("shared_memory"))
+        apply_region_options(j["shared_memory"], region);
+      if (block.contains("shared_memory"))
+        apply_region_options(block["shared_memory"], region);
+      if (region.seen_buckets == 0)
+        continue;
+
+      int buckets = 1;
+      while (buckets < region.seen_buckets)
+        buckets <<= 1;
+      int kept = std::max(1, region.generations - 1);
+      generations = generations ? std::min(generations, kept) : kept;
+      records = records ? std::min(records, buckets / 2) : buckets / 2;
+      if (region.window_ms > 0)
+      {
+        int age = std::max(1, region.window_ms / region.generations);
+        generation_ms = generation_ms ? std::min(generation_ms, age) : age;
+      }
+    }
+
+    if (options.generations == 0)
+      options.generations = generations ? generations : 3;
+    if (options.generation_records == 0)
+      options.generation_records = records;
+    if (options.generation_ms == 0)
+      options.generation_ms = generation_ms;
+  }
+
+  void apply_placement_options(const json &block, const json &nodes, PlacementOptions &options)
+  {
+    options.vnodes = std::max(1, block.value("vnodes", options.vnodes));
+    if (!block.contains("weights"))
+      return;
+
+    for (auto &[node, weight] : block["weights"].items())
+    {
+      if (!nodes.contains(node))
+        throw std::runtime_error("Unknown placement node: " + node);
+      int value = weight.get<int>();
+      if (value < 0)
+        throw std::runtime_error("Negative placement weight for node: " + node);
+      if (value > 0)
+        options.weights[node] = value;
+    }
+  }
+}
+
 RoutingConfig load_config(const std::string &filepath, const std::string &node_name)
 {
   std::ifstream in(filepath);
@@ -42,5 +246,105 @@ RoutingConfig load_config(const std::string &filepath, const std::string &node_n
     config.address_map[key] = val;
   }
 
+  // Per-edge channel settings: "channel_defaults" applies to every edge,
+  // "edges" entries keyed "<from>-><to>" override it.
+  for (const auto &neighbor : config.neighbors)
+  {
+    EdgeOptions options;
+    if (j.contains("channel_defaults"))
+    {
+      apply_edge_options(j["channel_defaults"], options);
+    }
+
+    std::string edge = node_name + "->" + neighbor;
+    if (j.contains("edges") && j["edges"].contains(edge))
+    {
+      apply_edge_options(j["edges"][edge], options);
+    }
+    config.edge_options[neighbor] = options;
+  }
+
+  // Batching: top-level "batching" block, optionally overridden per node.
+  if (j.contains("batching"))
+  {
+    apply_batch_options(j["batching"], config.batching);
+  }
+  if (j["nodes"][node_name].contains("batching"))
+  {
+    apply_batch_options(j["nodes"][node_name]["batching"], config.batching);
+  }
+
+  // Storage: top-level "storage" block, optionally overridden per node.
+  if (j.contains("storage"))
+  {
+    apply_storage_options(j["storage"], config.storage);
+  }
+  if (j["nodes"][node_name].contains("storage"))
+  {
+    apply_storage_options(j["nodes"][node_name]["storage"], config.storage);
+  }
+
+  // Logging: top-level "logging" block, optionally overridden per node.
+  if (j.contains("logging"))
+  {
+    apply_logging_options(j["logging"], config.logging);
+  }
+  if (j["nodes"][node_name].contains("logging"))
+  {
+    apply_logging_options(j["nodes"][node_name]["logging"], config.logging);
+  }
+
+  if (j.contains("tracing"))
+  {
+    apply_tracing_options(j["tracing"], config.tracing);
+  }
+
+  // Backpressure: top-level "backpressure" block, optionally overridden per node.
+  if (j.contains("backpressure"))
+  {
+    apply_backpressure_options(j["backpressure"], config.backpressure);
+  }
+  if (j["nodes"][node_name].contains("backpressure"))
+  {
+    apply_backpressure_options(j["nodes"][node_name]["backpressure"], config.backpressure);
+  }
+
+  if (j.contains("seen_summary"))
+  {
+    apply_seen_summary_options(j["seen_summary"], config.seen_summary);
+  }
+  apply_summary_window(j, config.seen_summary);
+
+  if (j.contains("placement"))
+  {
+    apply_placement_options(j["placement"], j["nodes"], config.placement);
+  }
+
+  if (j["nodes"][node_name].contains("scatter"))
+  {
+    apply_scatter_options(j["nodes"][node_name]["scatter"], config.scatter);
+  }
+
+  // Shared memory: a region for every node on this node's host, sized by the
+  // top-level "shared_memory" block and per-node overrides.
+  std::string host = host_of(j["nodes"], config, node_name);
+  for (auto &[node, block] : j["nodes"].items())
+  {
+    if (node != node_name && (host.empty() || host_of(j["nodes"], config, node) != host))
+      continue;
+
+    ShmRegionOptions region;
+    region.node = node;
+    if (j.contains("shared_memory"))
+    {
+      apply_region_options(j["shared_memory"], region);
+    }
+    if (block.contains("shared_memory"))
+    {
+      apply_region_options(block["shared_memory"], region);
+    }
+    config.shared_memory.regions.push_back(region);
+  }
+
   return config;
 }
@@ -1,8 +1,134 @@
 #pragma once
+#include <map>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+// gRPC channel settings for one outgoing edge (this node -> neighbor).
+struct EdgeOptions
+{
+  int connections = 1;    // striped HTTP/2 connections to the neighbor
+  int deadline_ms = 2000; // per-call deadline for forwards on this edge
+  std::unordered_map<std::string, int> int_args;
+  std::unordered_map<std::string, std::string> string_args;
+};
+
+// Record batching on outgoing edges (see batcher.h).
+struct BatchOptions
+{
+  bool enabled = false;
+  int max_records = 64; // flush when a batch holds this many records
+  int linger_ms = 5;    // ... or when its oldest record has waited this long
+};
+
+// How node B hands records to its scatter workers (see scatter.h).
+enum class ScatterMode
+{
+  Processes, // forked workers fed through shared-memory rings
+  Threads    // in-process work-stealing pool
+};
+
+// How processes mode picks a worker ring for each record.
+enum class ScatterDispatch
+{
+  RoundRobin,
+  PowerOfTwo // p2c over each worker's service-time EWMA x queued records
+};
+
+struct ScatterOptions
+{
+  ScatterMode mode = ScatterMode::Processes;
+  int workers = 3; // 0 = one per hardware thread
+  ScatterDispatch dispatch = ScatterDispatch::RoundRobin;
+};
+
+// When appended node data reaches disk (see appender.h).
+enum class Durability
+{
+  None,          // leave it to the page cache
+  Periodic,      // fsync every fsync_interval_ms
+  FsyncBeforeAck // a record is acked only after the fsync covering it
+};
+
+struct StorageOptions
+{
+  Durability durability = Durability::None;
+  int fsync_interval_ms = 100;
+};
+
+enum class LogLevel
+{
+  Debug = 0,
+  Info = 1,
+  Warn = 2,
+  Error = 3,
+  Off = 4
+};
+
+// Runtime log filtering (see logger.h).
+struct LoggingOptions
+{
+  LogLevel level = LogLevel::Info;
+  int sample_every = 1; // LOG_SAMPLED sites emit 1 in N calls
+};
+
+// Sampled end-to-end tracing (see trace.h).
+struct TracingOptions
+{
+  bool enabled = false;
+  int sample_every = 100; // node A traces 1 in N records
+};
+
+// Credit-based flow control on every edge (see credits.h).
+struct BackpressureOptions
+{
+  bool enabled = false;
+  int max_in_flight = 256;   // records a node holds / sends per edge unacked
+  int queue_limit = 1024;    // records allowed to wait beyond that before rejecting
+  int queue_timeout_ms = 50; // longest a record waits for a credit
+};
+
+// Fingerprint summary pushed up the tree to node A (see seen_summary.h).
+struct SeenSummaryOptions
+{
+  bool enabled = false;
+  int bloom_bits = 1 << 23;          // each of A's filter generations, rounded up to a power of two
+  int hashes = 7;                    // filter bits set per fingerprint
+  double max_false_positive = 0.001; // cap on A's filter over its whole window
+  int max_push = 256;                // fingerprints per response trailer
+  int queue_limit = 1 << 16;         // fingerprints a node holds for upstream
+
+  // A's window, by default the shortest any SeenSet guarantees (see
+  // load_config): generations of generation_records fingerprints each, also
+  // closed after generation_ms when > 0.
+  int generations = 0;
+  int generation_records = 0; // 0 = only the false-positive cap closes one
+  int generation_ms = 0;
+};
+
+// Consistent-hash placement for the consistenthash strategy (see hash_ring.h).
+struct PlacementOptions
+{
+  int vnodes = 64;                    // ring points per unit of weight
+  std::map<std::string, int> weights; // storage node -> weight; empty = off
+};
+
+// One node's region in its host's shared-memory segment (see shm_segment.h).
+struct ShmRegionOptions
+{
+  std::string node;
+  int seen_buckets = 1 << 18;  // per SeenSet generation, rounded up to a power of two; 0 = no SeenSet
+  int arena_bytes = 512 << 10; // payload text arena per generation
+  int generations = 4;         // dedup window, in generations of seen_buckets / 2 records
+  int window_ms = 0;           // > 0: generations also close after window_ms / generations
+};
+
+// Layout of the segment shared by every node on this node's host.
+struct SharedMemoryOptions
+{
+  std::vector<ShmRegionOptions> regions; // sorted by node name
+};
+
 struct RoutingConfig
 {
   std::string node_name;
@@ -10,6 +136,16 @@ struct RoutingConfig
   std::unordered_map<std::string, std::vector<std::string>> routing_table;
   std::unordered_map<std::string, std::string> address_map;
   std::vector<std::string> neighbors; // ✅ Add this
+  std::unordered_map<std::string, EdgeOptions> edge_options; // keyed by neighbor name
+  BatchOptions batching;
+  ScatterOptions scatter;
+  StorageOptions storage;
+  LoggingOptions logging;
+  TracingOptions tracing;
+  PlacementOptions placement;
+  BackpressureOptions backpressure;
+  SeenSummaryOptions seen_summary;
+  SharedMemoryOptions shared_memory;
 };
 
 RoutingConfig load_config(const std::string &filepath, const std::string &node_name);
@@ -0,0 +1,264 @@
+#include "credits.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+CreditGate::CreditGate(const BackpressureOptions &options, int shares)
+    : options_(options), shares_(std::max(1, shares)), max_limit_(std::max(1, options.max_in_flight / shares_)),
+      limit_(max_limit_)
+{
+}
+
+bool CreditGate::acquire(int records, std::chrono::milliseconds max_wait)
+{
+  std::unique_lock<std::mutex> lock(mu_);
+  // A request larger than the whole window goes out alone.
+  auto fits = [this, records]
+  { return in_flight_ == 0 || in_flight_ + records <= limit_; };
+  if (fits())
+  {
+    in_flight_ += records;
+    return true;
+  }
+
+  bool forever = max_wait == kWaitForever;
+  if (!forever && (max_wait.count() == 0 || waiting_ + records > options_.queue_limit))
+    return false;
+
+  waiting_ += records;
+  bool got = true;
+  if (forever)
+    cv_.wait(lock, fits);
+  else
+    got = cv_.wait_for(lock, max_wait, fits);
+  waiting_ -= records;
+  if (got)
+    in_flight_ += records;
+  return got;
+}
+
+void CreditGate::release(int records, int granted)
+{
+  std::lock_guard<std::mutex> lock(mu_);
+  in_flight_ = std::max(0, in_flight_ - records);
+  // The grant is what the downstream can take beyond what we still have in
+  // flight to it. Keep at least one credit so a new grant can arrive.
+  if (granted >= 0)
+    limit_ = std::clamp(in_flight_ + granted / shares_, 1, max_limit_);
+  cv_.notify_all();
+}
+
+int CreditGate::in_flight()
+{
+  std::lock_guard<std::mutex> lock(mu_);
+  return in_flight_;
+}
+
+int CreditGate::waiting()
+{
+  std::lock_guard<std::mutex> lock(mu_);
+  return waiting_;
+}
+
+EdgeCredits::EdgeCredits(const std::vector<std::string> &neighbors, const BackpressureOptions &options, int shares)
+    : options_(options)
+{
+  for (const auto &neighbor : neighbors)
+    gates_[neighbor] = std::make_unique<CreditGate>(options, shares);
+}
+
+bool EdgeCredits::acquire(const std::map<std::string, int> &records, std::chrono::milliseconds max_wait)
+{
+  // Ordered by neighbor name, and handed back on failure, so concurrent
+  // multi-edge acquires cannot hold each other up.
+  for (auto it = records.begin(); it != records.end(); ++it)
+  {
+    if (!acquire(it->first, it->second, max_wait))
+    {
+      for (auto taken = records.begin(); taken != it; ++taken)
+        release(taken->first, taken->second, nullptr);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool EdgeCredits::acquire(const std::vector<std::string> &neighbors, int records, std::chrono::milliseconds max_wait)
+{
+  std::map<std::string, int> each;
+  for (const auto &neighbor : neighbors)
+    each[neighbor] += records;
+  return acquire(each, max_wait);
+}
+
+bool EdgeCredits::acquire(const std::string &neighbor, int records, std::chrono::milliseconds max_wait)
+{
+  auto it = gates_.find(neighbor);
+  return it == gates_.end() || it->second->acquire(records, max_wait);
+}
+
+bool EdgeCredits::acquire(const std::string &neighbor, int records)
+{
+  return acquire(neighbor, records, queue_timeout());
+}
+
+void EdgeCredits::release(const std::string &neighbor, int records, const grpc::ClientContext *context)
+{
+  auto it = gates_.find(neighbor);
+  if (it == gates_.end())
+    return;
+
+  int granted = -1;
+  if (context)
+  {
+    const auto &trailers = context->GetServerTrailingMetadata();
+    auto grant = trailers.find(kCreditHeader);
+    if (grant != trailers.end())
+      granted = std::atoi(std::string(grant->second.data(), grant->second.size()).c_str());
+  }
+  it->second->release(records, granted);
+}
+
+int EdgeCredits::in_flight()
+{
+  int total = 0;
+  for (auto &[neighbor, gate] : gates_)
+    total += gate->in_flight();
+  return total;
+}
+
+int EdgeCredits::waiting()
+{
+  int total = 0;
+  for (auto &[neighbor, gate] : gates_)
+    total += gate->waiting();
+  return total;
+}
+
+OverloadRetries::OverloadRetries(EdgeCredits &credits, Send send)
+    : credits_(credits), send_(std::move(send)), thread_([this]
+                                                         { run(); })
+{
+}
+
+OverloadRetries::~OverloadRetries()
+{
+  stop();
+}
+
+bool OverloadRetries::retry(const std::string &neighbor, const dataservice::DataRequest &record,
+                            const grpc::Status &status)
+{
+  if (status.error_code() != grpc::StatusCode::RESOURCE_EXHAUSTED)
+    return false;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (stopping_)
+    {
+      LOG_ERROR("❌ Dropped a record " << neighbor << " rejected during shutdown");
+      return false;
+    }
+    queue_.emplace_back(neighbor, record);
+  }
+  cv_.notify_one();
+  LOG_SAMPLED(LogLevel::Warn, "⏳ " << neighbor << " is overloaded; retrying a record in " << kOverloadRetryDelay.count() << " ms");
+  return true;
+}
+
+void OverloadRetries::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (stopping_)
+      return;
+    stopping_ = true;
+    if (!queue_.empty())
+      LOG_ERROR("❌ Dropped " << queue_.size() << " record(s) still waiting to be retried");
+    queue_.clear();
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+int OverloadRetries::queued()
+{
+  std::lock_guard<std::mutex> lock(mu_);
+  return static_cast<int>(queue_.size());
+}
+
+void OverloadRetries::run()
+{
+  std::unique_lock<std::mutex> lock(mu_);
+  while (true)
+  {
+    cv_.wait(lock, [this]
+             { return stopping_ || !queue_.empty(); });
+    // Give the neighbor a moment to drain before trying again.
+    if (cv_.wait_for(lock, kOverloadRetryDelay, [this]
+                     { return stopping_; }))
+      return;
+
+    auto due = std::move(queue_);
+    queue_.clear();
+    lock.unlock();
+    for (const auto &[neighbor, record] : due)
+    {
+      credits_.acquire(neighbor, 1, kWaitForever);
+      send_(neighbor, record);
+    }
+    lock.lock();
+  }
+}
+
+bool Admission::admit(int records)
+{
+  int held = held_.fetch_add(records, std::memory_order_relaxed);
+  if (held > 0 && over_budget(options_, held, records))
+  {
+    held_.fetch_sub(records, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+void Admission::done(int records)
+{
+  held_.fetch_sub(records, std::memory_order_relaxed);
+}
+
+int Admission::credits() const
+{
+  return credits_for(options_, held());
+}
+
+Admitted::Admitted(Admission *admission, int records)
+    : admission_(admission), records_(records), ok_(!admission || admission->admit(records))
+{
+}
+
+Admitted::~Admitted()
+{
+  if (admission_ && ok_)
+    admission_->done(records_);
+}
+
+bool over_budget(const BackpressureOptions &options, int backlog, int records)
+{
+  return backlog + records > options.max_in_flight + options.queue_limit;
+}
+
+int credits_for(const BackpressureOptions &options, int backlog)
+{
+  return std::max(0, options.max_in_flight - backlog);
+}
+
+void grant_credits(grpc::ServerContextBase &context, int credits)
+{
+  context.AddTrailingMetadata(kCreditHeader, std::to_string(credits));
+}
+
+grpc::Status overloaded(const std::string &node)
+{
+  return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "node " + node + " is overloaded");
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include "config_loader.h"
+#include "data.pb.h"
+
+#include <grpcpp/grpcpp.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Credit-based backpressure. Every node admits at most max_in_flight +
+// queue_limit records at a time and rejects the rest with RESOURCE_EXHAUSTED.
+// In the x-mini2-credits trailer of each response it grants its upstream the
+// records it can still take without queueing. Upstream, one CreditGate per
+// edge keeps sends within that grant (and max_in_flight). Records that find no
+// credit wait in a queue bounded by queue_limit and queue_timeout_ms.
+// Overload at any hop thus fills the queues behind it until node A rejects.
+
+constexpr char kCreditHeader[] = "x-mini2-credits";
+
+// Wait without a deadline; for workers that must not drop acked records.
+constexpr std::chrono::milliseconds kWaitForever = std::chrono::milliseconds::max();
+
+class CreditGate
+{
+public:
+  // `shares` > 1 when that many independent processes send on the same
+  // edge: each gate then holds its share of max_in_flight and of every grant.
+  explicit CreditGate(const BackpressureOptions &options, int shares = 1);
+
+  // Takes `records` credits, queueing for up to `max_wait` when the window is
+  // full. False if the queue budget is spent or the wait timed out.
+  bool acquire(int records, std::chrono::milliseconds max_wait);
+
+  // Returns credits; `granted` (>= 0) is the downstream's latest grant.
+  void release(int records, int granted);
+
+  int in_flight();
+  int waiting();
+
+private:
+  BackpressureOptions options_;
+  int shares_;
+  int max_limit_; // this gate's share of max_in_flight
+  std::mutex mu_;
+  std::condition_variable cv_;
+  int limit_;
+  int in_flight_ = 0;
+  int waiting_ = 0;
+};
+
+// This node's gates, one per neighbor.
+class EdgeCredits
+{
+public:
+  EdgeCredits(const std::vector<std::string> &neighbors, const BackpressureOptions &options, int shares = 1);
+
+  // Credits toward every neighbor in `records`, all or nothing. Neighbors
+  // without a gate need none.
+  bool acquire(const std::map<std::string, int> &records, std::chrono::milliseconds max_wait);
+  bool acquire(const std::vector<std::string> &neighbors, int records, std::chrono::milliseconds max_wait);
+  bool acquire(const std::string &neighbor, int records, std::chrono::milliseconds max_wait);
+  // Same, waiting at most queue_timeout_ms.
+  bool acquire(const std::string &neighbor, int records);
+
+  // Returns credits once a call completes, taking the grant from its trailers
+  // (context may be null when the call never went out).
+  void release(const std::string &neighbor, int records, const grpc::ClientContext *context);
+
+  int in_flight();
+  int waiting();
+  std::chrono::milliseconds queue_timeout() const { return std::chrono::milliseconds(options_.queue_timeout_ms); }
+
+private:
+  BackpressureOptions options_;
+  std::unordered_map<std::string, std::unique_ptr<CreditGate>> gates_;
+};
+
+// How long a record turned away by an overloaded neighbor waits before it
+// is sent again.
+constexpr std::chrono::milliseconds kOverloadRetryDelay{20};
+
+// Records a neighbor rejected with RESOURCE_EXHAUSTED after this node had
+// already acked them upstream, so the rejection cannot be passed back. A
+// background thread sends each one again after kOverloadRetryDelay, once a
+// credit toward the neighbor is free; `send` routes it as before, and a
+// repeated rejection comes back through retry().
+class OverloadRetries
+{
+public:
+  using Send = std::function<void(const std::string &neighbor, const dataservice::DataRequest &record)>;
+
+  OverloadRetries(EdgeCredits &credits, Send send);
+  ~OverloadRetries();
+
+  OverloadRetries(const OverloadRetries &) = delete;
+  OverloadRetries &operator=(const OverloadRetries &) = delete;
+
+  // Queues `record` if `status` is RESOURCE_EXHAUSTED; true if it was.
+  bool retry(const std::string &neighbor, const dataservice::DataRequest &record, const grpc::Status &status);
+  // Stops sending; records queued or rejected from here on are dropped.
+  // Call before tearing down whatever `send` uses.
+  void stop();
+
+  int queued();
+
+private:
+  void run();
+
+  EdgeCredits &credits_;
+  Send send_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<std::pair<std::string, dataservice::DataRequest>> queue_;
+  bool stopping_ = false;
+  std::thread thread_;
+};
+
+// Downstream side: counts records held by this node's handlers.
+class Admission
+{
+public:
+  explicit Admission(const BackpressureOptions &options) : options_(options) {}
+
+  bool admit(int records);
+  void done(int records);
+  int held() const { return held_.load(std::memory_order_relaxed); }
+  int credits() const;
+
+private:
+  BackpressureOptions options_;
+  std::atomic<int> held_{0};
+};
+
+// Holds admitted records for the rest of a handler. A null admission
+// (backpressure disabled) admits everything.
+class Admitted
+{
+public:
+  Admitted(Admission *admission, int records);
+  ~Admitted();
+
+  Admitted(const Admitted &) = delete;
+  Admitted &operator=(const Admitted &) = delete;
+
+  bool ok() const { return ok_; }
+
+private:
+  Admission *admission_;
+  int records_;
+  bool ok_;
+};
+
+// Whether `backlog` + `records` exceeds the node's budget, and the credits
+// to grant while `backlog` records are held.
+bool over_budget(const BackpressureOptions &options, int backlog, int records);
+int credits_for(const BackpressureOptions &options, int backlog);
+
+void grant_credits(grpc::ServerContextBase &context, int credits);
+grpc::Status overloaded(const std::string &node);
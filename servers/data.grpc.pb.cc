@@ -1,86 +0,0 @@
-// Generated by the gRPC C++ plugin.
-// If you make any local change, they will be lost.
-// source: data.proto
-
-#include "data.pb.h"
-#include "data.grpc.pb.h"
-
-#include <functional>
-#include <grpcpp/support/async_stream.h>
-#include <grpcpp/support/async_unary_call.h>
-#include <grpcpp/impl/channel_interface.h>
-#include <grpcpp/impl/client_unary_call.h>
-#include <grpcpp/support/client_callback.h>
-#include <grpcpp/support/message_allocator.h>
-#include <grpcpp/support/method_handler.h>
-#include <grpcpp/impl/rpc_service_method.h>
-#include <grpcpp/support/server_callback.h>
-#include <grpcpp/impl/server_callback_handlers.h>
-#include <grpcpp/server_context.h>
-#include <grpcpp/impl/service_type.h>
-#include <grpcpp/support/sync_stream.h>
-namespace dataservice {
-
-static const char* DataService_method_names[] = {
-  "/dataservice.DataService/SendData",
-};
-
-std::unique_ptr< DataService::Stub> DataService::NewStub(const std::shared_ptr< ::grpc::ChannelInterface>& channel, const ::grpc::StubOptions& options) {
-  (void)options;
-  std::unique_ptr< DataService::Stub> stub(new DataService::Stub(channel, options));
-  return stub;
-}
-
-DataService::Stub::Stub(const std::shared_ptr< ::grpc::ChannelInterface>& channel, const ::grpc::StubOptions& options)
-  : channel_(channel), rpcmethod_SendData_(DataService_method_names[0], options.suffix_for_stats(),::grpc::internal::RpcMethod::NORMAL_RPC, channel)
-  {}
-
-::grpc::Status DataService::Stub::SendData(::grpc::ClientContext* context, const ::dataservice::DataRequest& request, ::dataservice::Empty* response) {
-  return ::grpc::internal::BlockingUnaryCall< ::dataservice::DataRequest, ::dataservice::Empty, ::grpc::protobuf::MessageLite, ::grpc::protobuf::MessageLite>(channel_.get(), rpcmethod_SendData_, context, request, response);
-}
-
-void DataService::Stub::async::SendData(::grpc::ClientContext* context, const ::dataservice::DataRequest* request, ::dataservice::Empty* response, std::function<void(::grpc::Status)> f) {
-  ::grpc::internal::CallbackUnaryCall< ::dataservice::DataRequest, ::dataservice::Empty, ::grpc::protobuf::MessageLite, ::grpc::protobuf::MessageLite>(stub_->channel_.get(), stub_->rpcmethod_SendData_, context, request, response, std::move(f));
-}
-
-void DataService::Stub::async::SendData(::grpc::ClientContext* context, const ::dataservice::DataRequest* request, ::dataservice::Empty* response, ::grpc::ClientUnaryReactor* reactor) {
-  ::grpc::internal::ClientCallbackUnaryFactory::Create< ::grpc::protobuf::MessageLite, ::grpc::protobuf::MessageLite>(stub_->channel_.get(), stub_->rpcmethod_SendData_, context, request, response, reactor);
-}
-
-::grpc::ClientAsyncResponseReader< ::dataservice::Empty>* DataService::Stub::PrepareAsyncSendDataRaw(::grpc::ClientContext* context, const ::dataservice::DataRequest& request, ::grpc::CompletionQueue* cq) {
-  return ::grpc::internal::ClientAsyncResponseReaderHelper::Create< ::dataservice::Empty, ::dataservice::DataRequest, ::grpc::protobuf::MessageLite, ::grpc::protobuf::MessageLite>(channel_.get(), cq, rpcmethod_SendData_, context, request);
-}
-
-::grpc::ClientAsyncResponseReader< ::dataservice::Empty>* DataService::Stub::AsyncSendDataRaw(::grpc::ClientContext* context, const ::dataservice::DataRequest& request, ::grpc::CompletionQueue* cq) {
-  auto* result =
-    this->PrepareAsyncSendDataRaw(context, request, cq);
-  result->StartCall();
-  return result;
-}
-
-DataService::Service::Service() {
-  AddMethod(new ::grpc::internal::RpcServiceMethod(
-      DataService_method_names[0],
-      ::grpc::internal::RpcMethod::NORMAL_RPC,
-      new ::grpc::internal::RpcMethodHandler< DataService::Service, ::dataservice::DataRequest, ::dataservice::Empty, ::grpc::protobuf::MessageLite, ::grpc::protobuf::MessageLite>(
-          [](DataService::Service* service,
-             ::grpc::ServerContext* ctx,
-             const ::dataservice::DataRequest* req,
-             ::dataservice::Empty* resp) {
-               return service->SendData(ctx, req, resp);
-             }, this)));
-}
-
-DataService::Service::~Service() {
-}
-
-::grpc::Status DataService::Service::SendData(::grpc::ServerContext* context, const ::dataservice::DataRequest* request, ::dataservice::Empty* response) {
-  (void) context;
-  (void) request;
-  (void) response;
-  return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
-}
-
-
-}  // namespace dataservice
-
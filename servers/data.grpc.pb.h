@@ -1,242 +0,0 @@
-// Generated by the gRPC C++ plugin.
-// If you make any local change, they will be lost.
-// source: data.proto
-#ifndef GRPC_data_2eproto__INCLUDED
-#define GRPC_data_2eproto__INCLUDED
-
-#include "data.pb.h"
-
-#include <functional>
-#include <grpcpp/generic/async_generic_service.h>
-#include <grpcpp/support/async_stream.h>
-#include <grpcpp/support/async_unary_call.h>
-#include <grpcpp/support/client_callback.h>
-#include <grpcpp/client_context.h>
-#include <grpcpp/completion_queue.h>
-#include <grpcpp/support/message_allocator.h>
-#include <grpcpp/support/method_handler.h>
-#include <grpcpp/impl/proto_utils.h>
-#include <grpcpp/impl/rpc_method.h>
-#include <grpcpp/support/server_callback.h>
-#include <grpcpp/impl/server_callback_handlers.h>
-#include <grpcpp/server_context.h>
-#include <grpcpp/impl/service_type.h>
-#include <grpcpp/support/status.h>
-#include <grpcpp/support/stub_options.h>
-#include <grpcpp/support/sync_stream.h>
-#include <grpcpp/ports_def.inc>
-
-namespace dataservice {
-
-class DataService final {
- public:
-  static constexpr char const* service_full_name() {
-    return "dataservice.DataService";
-  }
-  class StubInterface {
-   public:
-    virtual ~StubInterface() {}
-    virtual ::grpc::Status SendData(::grpc::ClientContext* context, const ::dataservice::DataRequest& request, ::dataservice::Empty* response) = 0;
-    std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::dataservice::Empty>> AsyncSendData(::grpc::ClientContext* context, const ::dataservice::DataRequest& request, ::grpc::CompletionQueue* cq) {
-      return std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::dataservice::Empty>>(AsyncSendDataRaw(context, request, cq));
-    }
-    std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::dataservice::Empty>> PrepareAsyncSendData(::grpc::ClientContext* context, const ::dataservice::DataRequest& request, ::grpc::CompletionQueue* cq) {
-      return std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::dataservice::Empty>>(PrepareAsyncSendDataRaw(context, request, cq));
-    }
-    class async_interface {
-     public:
-      virtual ~async_interface() {}
-      virtual void SendData(::grpc::ClientContext* context, const ::dataservice::DataRequest* request, ::dataservice::Empty* response, std::function<void(::grpc::Status)>) = 0;
-      virtual void SendData(::grpc::ClientContext* context, const ::dataservice::DataRequest* request, ::dataservice::Empty* response, ::grpc::ClientUnaryReactor* reactor) = 0;
-    };
-    typedef class async_interface experimental_async_interface;
-    virtual class async_interface* async() { return nullptr; }
-    class async_interface* experimental_async() { return async(); }
-   private:
-    virtual ::grpc::ClientAsyncResponseReaderInterface< ::dataservice::Empty>* AsyncSendDataRaw(::grpc::ClientContext* context, const ::dataservice::DataRequest& request, ::grpc::CompletionQueue* cq) = 0;
-    virtual ::grpc::ClientAsyncResponseReaderInterface< ::dataservice::Empty>* PrepareAsyncSendDataRaw(::grpc::ClientContext* context, const ::dataservice::DataRequest& request, ::grpc::CompletionQueue* cq) = 0;
-  };
-  class Stub final : public StubInterface {
-   public:
-    Stub(const std::shared_ptr< ::grpc::ChannelInterface>& channel, const ::grpc::StubOptions& options = ::grpc::StubOptions());
-    ::grpc::Status SendData(::grpc::ClientContext* context, const ::dataservice::DataRequest& request, ::dataservice::Empty* response) override;
-    std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::dataservice::Empty>> AsyncSendData(::grpc::ClientContext* context, const ::dataservice::DataRequest& request, ::grpc::CompletionQueue* cq) {
-      return std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::dataservice::Empty>>(AsyncSendDataRaw(context, request, cq));
-    }
-    std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::dataservice::Empty>> PrepareAsyncSendData(::grpc::ClientContext* context, const ::dataservice::DataRequest& request, ::grpc::CompletionQueue* cq) {
-      return std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::dataservice::Empty>>(PrepareAsyncSendDataRaw(context, request, cq));
-    }
-    class async final :
-      public StubInterface::async_interface {
-     public:
-      void SendData(::grpc::ClientContext* context, const ::dataservice::DataRequest* request, ::dataservice::Empty* response, std::function<void(::grpc::Status)>) override;
-      void SendData(::grpc::ClientContext* context, const ::dataservice::DataRequest* request, ::dataservice::Empty* response, ::grpc::ClientUnaryReactor* reactor) override;
-     private:
-      friend class Stub;
-      explicit async(Stub* stub): stub_(stub) { }
-      Stub* stub() { return stub_; }
-      Stub* stub_;
-    };
-    class async* async() override { return &async_stub_; }
-
-   private:
-    std::shared_ptr< ::grpc::ChannelInterface> channel_;
-    class async async_stub_{this};
-    ::grpc::ClientAsyncResponseReader< ::dataservice::Empty>* AsyncSendDataRaw(::grpc::ClientContext* context, const ::dataservice::DataRequest& request, ::grpc::CompletionQueue* cq) override;
-    ::grpc::ClientAsyncResponseReader< ::dataservice::Empty>* PrepareAsyncSendDataRaw(::grpc::ClientContext* context, const ::dataservice::DataRequest& request, ::grpc::CompletionQueue* cq) override;
-    const ::grpc::internal::RpcMethod rpcmethod_SendData_;
-  };
-  static std::unique_ptr<Stub> NewStub(const std::shared_ptr< ::grpc::ChannelInterface>& channel, const ::grpc::StubOptions& options = ::grpc::StubOptions());
-
-  class Service : public ::grpc::Service {
-   public:
-    Service();
-    virtual ~Service();
-    virtual ::grpc::Status SendData(::grpc::ServerContext* context, const ::dataservice::DataRequest* request, ::dataservice::Empty* response);
-  };
-  template <class BaseClass>
-  class WithAsyncMethod_SendData : public BaseClass {
-   private:
-    void BaseClassMustBeDerivedFromService(const Service* /*service*/) {}
-   public:
-    WithAsyncMethod_SendData() {
-      ::grpc::Service::MarkMethodAsync(0);
-    }
-    ~WithAsyncMethod_SendData() override {
-      BaseClassMustBeDerivedFromService(this);
-    }
-    // disable synchronous version of this method
-    ::grpc::Status SendData(::grpc::ServerContext* /*context*/, const ::dataservice::DataRequest* /*request*/, ::dataservice::Empty* /*response*/) override {
-      abort();
-      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
-    }
-    void RequestSendData(::grpc::ServerContext* context, ::dataservice::DataRequest* request, ::grpc::ServerAsyncResponseWriter< ::dataservice::Empty>* response, ::grpc::CompletionQueue* new_call_cq, ::grpc::ServerCompletionQueue* notification_cq, void *tag) {
-      ::grpc::Service::RequestAsyncUnary(0, context, request, response, new_call_cq, notification_cq, tag);
-    }
-  };
-  typedef WithAsyncMethod_SendData<Service > AsyncService;
-  template <class BaseClass>
-  class WithCallbackMethod_SendData : public BaseClass {
-   private:
-    void BaseClassMustBeDerivedFromService(const Service* /*service*/) {}
-   public:
-    WithCallbackMethod_SendData() {
-      ::grpc::Service::MarkMethodCallback(0,
-          new ::grpc::internal::CallbackUnaryHandler< ::dataservice::DataRequest, ::dataservice::Empty>(
-            [this](
-                   ::grpc::CallbackServerContext* context, const ::dataservice::DataRequest* request, ::dataservice::Empty* response) { return this->SendData(context, request, response); }));}
-    void SetMessageAllocatorFor_SendData(
-        ::grpc::MessageAllocator< ::dataservice::DataRequest, ::dataservice::Empty>* allocator) {
-      ::grpc::internal::MethodHandler* const handler = ::grpc::Service::GetHandler(0);
-      static_cast<::grpc::internal::CallbackUnaryHandler< ::dataservice::DataRequest, ::dataservice::Empty>*>(handler)
-              ->SetMessageAllocator(allocator);
-    }
-    ~WithCallbackMethod_SendData() override {
-      BaseClassMustBeDerivedFromService(this);
-    }
-    // disable synchronous version of this method
-    ::grpc::Status SendData(::grpc::ServerContext* /*context*/, const ::dataservice::DataRequest* /*request*/, ::dataservice::Empty* /*response*/) override {
-      abort();
-      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
-    }
-    virtual ::grpc::ServerUnaryReactor* SendData(
-      ::grpc::CallbackServerContext* /*context*/, const ::dataservice::DataRequest* /*request*/, ::dataservice::Empty* /*response*/)  { return nullptr; }
-  };
-  typedef WithCallbackMethod_SendData<Service > CallbackService;
-  typedef CallbackService ExperimentalCallbackService;
-  template <class BaseClass>
-  class WithGenericMethod_SendData : public BaseClass {
-   private:
-    void BaseClassMustBeDerivedFromService(const Service* /*service*/) {}
-   public:
-    WithGenericMethod_SendData() {
-      ::grpc::Service::MarkMethodGeneric(0);
-    }
-    ~WithGenericMethod_SendData() override {
-      BaseClassMustBeDerivedFromService(this);
-    }
-    // disable synchronous version of this method
-    ::grpc::Status SendData(::grpc::ServerContext* /*context*/, const ::dataservice::DataRequest* /*request*/, ::dataservice::Empty* /*response*/) override {
-      abort();
-      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
-    }
-  };
-  template <class BaseClass>
-  class WithRawMethod_SendData : public BaseClass {
-   private:
-    void BaseClassMustBeDerivedFromService(const Service* /*service*/) {}
-   public:
-    WithRawMethod_SendData() {
-      ::grpc::Service::MarkMethodRaw(0);
-    }
-    ~WithRawMethod_SendData() override {
-      BaseClassMustBeDerivedFromService(this);
-    }
-    // disable synchronous version of this method
-    ::grpc::Status SendData(::grpc::ServerContext* /*context*/, const ::dataservice::DataRequest* /*request*/, ::dataservice::Empty* /*response*/) override {
-      abort();
-      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
-    }
-    void RequestSendData(::grpc::ServerContext* context, ::grpc::ByteBuffer* request, ::grpc::ServerAsyncResponseWriter< ::grpc::ByteBuffer>* response, ::grpc::CompletionQueue* new_call_cq, ::grpc::ServerCompletionQueue* notification_cq, void *tag) {
-      ::grpc::Service::RequestAsyncUnary(0, context, request, response, new_call_cq, notification_cq, tag);
-    }
-  };
-  template <class BaseClass>
-  class WithRawCallbackMethod_SendData : public BaseClass {
-   private:
-    void BaseClassMustBeDerivedFromService(const Service* /*service*/) {}
-   public:
-    WithRawCallbackMethod_SendData() {
-      ::grpc::Service::MarkMethodRawCallback(0,
-          new ::grpc::internal::CallbackUnaryHandler< ::grpc::ByteBuffer, ::grpc::ByteBuffer>(
-            [this](
-                   ::grpc::CallbackServerContext* context, const ::grpc::ByteBuffer* request, ::grpc::ByteBuffer* response) { return this->SendData(context, request, response); }));
-    }
-    ~WithRawCallbackMethod_SendData() override {
-      BaseClassMustBeDerivedFromService(this);
-    }
-    // disable synchronous version of this method
-    ::grpc::Status SendData(::grpc::ServerContext* /*context*/, const ::dataservice::DataRequest* /*request*/, ::dataservice::Empty* /*response*/) override {
-      abort();
-      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
-    }
-    virtual ::grpc::ServerUnaryReactor* SendData(
-      ::grpc::CallbackServerContext* /*context*/, const ::grpc::ByteBuffer* /*request*/, ::grpc::ByteBuffer* /*response*/)  { return nullptr; }
-  };
-  template <class BaseClass>
-  class WithStreamedUnaryMethod_SendData : public BaseClass {
-   private:
-    void BaseClassMustBeDerivedFromService(const Service* /*service*/) {}
-   public:
-    WithStreamedUnaryMethod_SendData() {
-      ::grpc::Service::MarkMethodStreamed(0,
-        new ::grpc::internal::StreamedUnaryHandler<
-          ::dataservice::DataRequest, ::dataservice::Empty>(
-            [this](::grpc::ServerContext* context,
-                   ::grpc::ServerUnaryStreamer<
-                     ::dataservice::DataRequest, ::dataservice::Empty>* streamer) {
-                       return this->StreamedSendData(context,
-                         streamer);
-                  }));
-    }
-    ~WithStreamedUnaryMethod_SendData() override {
-      BaseClassMustBeDerivedFromService(this);
-    }
-    // disable regular version of this method
-    ::grpc::Status SendData(::grpc::ServerContext* /*context*/, const ::dataservice::DataRequest* /*request*/, ::dataservice::Empty* /*response*/) override {
-      abort();
-      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
-    }
-    // replace default version of method with streamed unary
-    virtual ::grpc::Status StreamedSendData(::grpc::ServerContext* context, ::grpc::ServerUnaryStreamer< ::dataservice::DataRequest,::dataservice::Empty>* server_unary_streamer) = 0;
-  };
-  typedef WithStreamedUnaryMethod_SendData<Service > StreamedUnaryService;
-  typedef Service SplitStreamedService;
-  typedef WithStreamedUnaryMethod_SendData<Service > StreamedService;
-};
-
-}  // namespace dataservice
-
-
-#include <grpcpp/ports_undef.inc>
-#endif  // GRPC_data_2eproto__INCLUDED
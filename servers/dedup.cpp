@@ -0,0 +1,233 @@
+#include "dedup.h"
+
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+namespace
+{
+  // Longest a lookup waits for a bucket's text to be published. Copying it
+  // takes microseconds; a writer that has not finished by then was likely
+  // killed between claiming the bucket and publishing.
+  constexpr int64_t kPublishWaitNs = 10'000'000;
+
+  int64_t now_ns()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  uint64_t slot_bytes(uint64_t buckets, uint64_t arena_bytes)
+  {
+    return buckets * (sizeof(std::atomic<uint64_t>) + sizeof(std::atomic<int32_t>)) + (arena_bytes + 7) / 8 * 8;
+  }
+
+  // `text` is a slot value; 0 (bucket cleared under us) never matches.
+  bool same_payload(const SeenSet &seen, uint32_t slot, int32_t text, const std::string &payload)
+  {
+    if (text == 0)
+      return false;
+    if (text == SEEN_NO_SLOT)
+      return true; // text not kept; a 64-bit fingerprint match is taken as equal
+    const char *entry = seen.arena(slot) + (text - 1);
+    uint16_t length;
+    memcpy(&length, entry, sizeof(length));
+    return length == payload.size() && memcmp(entry + sizeof(length), payload.data(), length) == 0;
+  }
+
+  // Appends the payload to the generation's arena; its slot value, or
+  // SEEN_NO_SLOT when it does not fit.
+  int32_t store_text(SeenSet &seen, uint32_t slot, const std::string &payload)
+  {
+    if (payload.size() > UINT16_MAX)
+      return SEEN_NO_SLOT;
+    SeenGeneration &generation = seen.generation(slot);
+    uint16_t length = static_cast<uint16_t>(payload.size());
+    uint64_t bytes = sizeof(length) + length;
+    uint64_t offset = generation.arena_used.fetch_add(bytes, std::memory_order_relaxed);
+    if (offset + bytes > seen.arena_bytes)
+      return SEEN_NO_SLOT;
+
+    char *entry = seen.arena(slot) + offset;
+    memcpy(entry, &length, sizeof(length));
+    memcpy(entry + sizeof(length), payload.data(), length);
+    generation.texts.fetch_add(1, std::memory_order_relaxed);
+    return static_cast<int32_t>(offset + 1);
+  }
+
+  // A bucket's fingerprint is claimed before its text is copied; wait out
+  // that short window before comparing. Returns 0 (no match) if the bucket
+  // is cleared meanwhile because its generation left the window, or if the
+  // text is still missing after kPublishWaitNs. A dead writer's bucket thus
+  // costs a bounded wait and at worst one missed duplicate, never a hang.
+  int32_t published_text(const SeenSet &seen, uint32_t slot, uint64_t bucket, uint64_t fp)
+  {
+    int32_t text;
+    int64_t deadline = 0;
+    while ((text = seen.slots(slot)[bucket].load(std::memory_order_acquire)) == 0)
+    {
+      if (seen.fingerprints(slot)[bucket].load(std::memory_order_acquire) != fp)
+        return 0;
+      int64_t now = now_ns();
+      if (deadline == 0)
+        deadline = now + kPublishWaitNs;
+      else if (now >= deadline)
+        return 0;
+      std::this_thread::yield();
+    }
+    return text;
+  }
+
+  bool contains(const SeenSet &seen, uint32_t slot, uint64_t fp, const std::string &payload)
+  {
+    const uint64_t mask = seen.buckets - 1;
+    const std::atomic<uint64_t> *fingerprints = seen.fingerprints(slot);
+    for (uint64_t probe = 0, i = fp & mask; probe < seen.buckets; ++probe, i = (i + 1) & mask)
+    {
+      uint64_t current = fingerprints[i].load(std::memory_order_acquire);
+      if (current == 0)
+        return false;
+      if (current == fp && same_payload(seen, slot, published_text(seen, slot, i, fp), payload))
+        return true;
+    }
+    return false;
+  }
+
+  // Whether a generation in the window other than `current` holds the payload.
+  bool in_older_generations(const SeenSet &seen, uint64_t current, uint64_t fp, const std::string &payload)
+  {
+    for (uint64_t back = 1; back < seen.generations && back <= current; ++back)
+    {
+      if (contains(seen, seen.slot_of(current - back), fp, payload))
+        return true;
+    }
+    return false;
+  }
+
+  // Empties `generation`'s slot and tags it as prepared for that generation.
+  // Runs off the hot path: once per generation, by the thread that closed
+  // the one before, or by repair_seen_set() after it died half-way.
+  void clear_slot(SeenSet &seen, uint64_t prepared_for)
+  {
+    uint32_t slot = seen.slot_of(prepared_for);
+    SeenGeneration &generation = seen.generation(slot);
+    for (uint64_t i = 0; i < seen.buckets; ++i)
+      seen.fingerprints(slot)[i].store(0, std::memory_order_relaxed);
+    for (uint64_t i = 0; i < seen.buckets; ++i)
+      seen.slots(slot)[i].store(0, std::memory_order_relaxed);
+    generation.entries.store(0, std::memory_order_relaxed);
+    generation.texts.store(0, std::memory_order_relaxed);
+    generation.arena_used.store(0, std::memory_order_relaxed);
+    generation.prepared_for.store(prepared_for, std::memory_order_release);
+  }
+
+  // Closes generation `current` once half its buckets are taken (so probes
+  // stay short) or it has grown too old. Moving `current` on retires the
+  // oldest generation for every reader at once; the thread that did it then
+  // clears that slot to be the spare for the generation after. Only a spare
+  // tagged for current + 1 may be moved into, so a closer can never advance
+  // into a slot that is still being cleared.
+  void maybe_advance(SeenSet &seen, uint64_t current)
+  {
+    const SeenGeneration &open = seen.generation(seen.slot_of(current));
+    bool full = static_cast<uint64_t>(open.entries.load(std::memory_order_relaxed)) >= seen.buckets / 2;
+    if (!full && (seen.generation_ns == 0 || now_ns() - open.opened_ns.load(std::memory_order_relaxed) < seen.generation_ns))
+      return;
+
+    SeenGeneration &next = seen.generation(seen.slot_of(current + 1));
+    if (next.prepared_for.load(std::memory_order_acquire) != current + 1)
+      return; // the spare is still being cleared; keep filling this one
+    next.opened_ns.store(now_ns(), std::memory_order_relaxed);
+    if (!seen.current.compare_exchange_strong(current, current + 1, std::memory_order_acq_rel))
+      return;
+
+    // current + 1 - generations just left the window; its slot is next's next.
+    if (current + 1 >= seen.generations)
+      clear_slot(seen, current + 2);
+  }
+}
+
+size_t seen_set_bytes(uint64_t buckets, uint64_t arena_bytes, uint32_t generations)
+{
+  return sizeof(SeenSet) + (generations + 1) * (sizeof(SeenGeneration) + slot_bytes(buckets, arena_bytes));
+}
+
+SeenSet *init_seen_set(void *memory, uint64_t buckets, uint64_t arena_bytes, uint32_t generations,
+                       int64_t generation_ns)
+{
+  auto *seen = new (memory) SeenSet;
+  seen->generations = generations;
+  seen->buckets = buckets;
+  seen->arena_bytes = arena_bytes;
+  seen->generation_ns = generation_ns;
+  seen->slot_bytes = slot_bytes(buckets, arena_bytes);
+  for (uint32_t slot = 0; slot < seen->slot_count(); ++slot)
+  {
+    auto *generation = new (&seen->generation(slot)) SeenGeneration;
+    generation->prepared_for.store(slot, std::memory_order_relaxed);
+  }
+  seen->generation(0).opened_ns.store(now_ns(), std::memory_order_relaxed);
+  return seen;
+}
+
+void repair_seen_set(SeenSet &seen)
+{
+  uint64_t spare = seen.current.load(std::memory_order_acquire) + 1;
+  if (seen.generation(seen.slot_of(spare)).prepared_for.load(std::memory_order_acquire) != spare)
+    clear_slot(seen, spare);
+}
+
+uint64_t payload_fingerprint(const std::string &payload)
+{
+  // FNV-1a, then a murmur3 finalizer so the low bits index well.
+  uint64_t h = 1469598103934665603ULL;
+  for (unsigned char c : payload)
+  {
+    h ^= c;
+    h *= 1099511628211ULL;
+  }
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h ? h : 1; // 0 marks an empty bucket
+}
+
+bool is_duplicate(SeenSet &seen, const std::string &payload)
+{
+  uint64_t fp = payload_fingerprint(payload);
+  uint64_t current = seen.current.load(std::memory_order_acquire);
+  return contains(seen, seen.slot_of(current), fp, payload) || in_older_generations(seen, current, fp, payload);
+}
+
+bool mark_processed(SeenSet &seen, const std::string &payload)
+{
+  uint64_t fp = payload_fingerprint(payload);
+  uint64_t current = seen.current.load(std::memory_order_acquire);
+  if (in_older_generations(seen, current, fp, payload))
+    return false;
+
+  uint32_t slot = seen.slot_of(current);
+  std::atomic<uint64_t> *fingerprints = seen.fingerprints(slot);
+  const uint64_t mask = seen.buckets - 1;
+  for (uint64_t probe = 0, i = fp & mask; probe < seen.buckets; ++probe, i = (i + 1) & mask)
+  {
+    uint64_t existing = fingerprints[i].load(std::memory_order_acquire);
+    if (existing == 0 && fingerprints[i].compare_exchange_strong(existing, fp, std::memory_order_acq_rel))
+    {
+      seen.slots(slot)[i].store(store_text(seen, slot, payload), std::memory_order_release);
+      seen.generation(slot).entries.fetch_add(1, std::memory_order_relaxed);
+      maybe_advance(seen, current);
+      return true;
+    }
+
+    // Lost the race for an empty bucket (existing now holds the winner), or
+    // the bucket was already taken: it is ours only on a full match.
+    if (existing == fp && same_payload(seen, slot, published_text(seen, slot, i, fp), payload))
+      return false;
+  }
+  maybe_advance(seen, current);
+  return true; // generation full and not yet closed: let it through unrecorded
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "shared_data.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Lock-free duplicate detection over a SeenSet in shared memory. Safe to call
+// concurrently from any thread of any process attached to the segment.
+// A payload is remembered while its generation is in the window: at least
+// (generations - 1) * buckets / 2 later records, and at least generation_ns *
+// (generations - 1) when generations also close on age.
+
+// Bytes taken by a SeenSet of `generations` generations, each with `buckets`
+// index buckets (a power of two) and an `arena_bytes` text arena, and laying
+// one out in zeroed memory that size. `generation_ns` > 0 also closes a
+// generation once it is that old.
+size_t seen_set_bytes(uint64_t buckets, uint64_t arena_bytes, uint32_t generations);
+SeenSet *init_seen_set(void *memory, uint64_t buckets, uint64_t arena_bytes, uint32_t generations,
+                       int64_t generation_ns);
+
+// Finishes clearing the spare generation if a process died preparing it,
+// which would otherwise stop the window from moving. Only for a set no
+// live process is writing, e.g. when its node's region is taken over.
+void repair_seen_set(SeenSet &seen);
+
+uint64_t payload_fingerprint(const std::string &payload);
+
+bool is_duplicate(SeenSet &seen, const std::string &payload);
+
+// Records the payload. Returns false if it is already in the window, so a
+// single call is an atomic check-and-mark. A payload that finds the current
+// generation full (its successor is still being cleared) is let through
+// unrecorded.
+bool mark_processed(SeenSet &seen, const std::string &payload);
@@ -0,0 +1,72 @@
+#include "fanout.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+using dataservice::DataRequest;
+using dataservice::DataService;
+using dataservice::Empty;
+
+namespace
+{
+  struct Call
+  {
+    grpc::ClientContext context;
+    Empty response;
+    std::chrono::steady_clock::time_point sent;
+  };
+}
+
+std::vector<FanoutResult> fan_out(ChannelRegistry &channels, const std::vector<std::string> &neighbors,
+                                  const DataRequest &request, const FanoutPrepare &prepare,
+                                  const FanoutDone &done)
+{
+  std::vector<FanoutResult> results(neighbors.size());
+  std::vector<std::unique_ptr<Call>> calls(neighbors.size());
+  std::mutex mu;
+  std::condition_variable cv;
+  size_t remaining = neighbors.size();
+
+  for (size_t i = 0; i < neighbors.size(); ++i)
+  {
+    results[i].neighbor = neighbors[i];
+    DataService::Stub *stub = channels.stub(neighbors[i]);
+    if (!stub)
+    {
+      results[i].status = grpc::Status(grpc::StatusCode::UNAVAILABLE, "no channel to " + neighbors[i]);
+      if (done)
+        done(results[i], nullptr);
+      std::lock_guard<std::mutex> lock(mu);
+      remaining--;
+      continue;
+    }
+
+    calls[i] = std::make_unique<Call>();
+    Call *call = calls[i].get();
+    channels.set_deadline(call->context, neighbors[i]);
+    if (prepare)
+      prepare(call->context);
+    call->sent = std::chrono::steady_clock::now();
+    results[i].sent = true;
+    stub->async()->SendData(&call->context, &request, &call->response,
+                            [&, i, call](grpc::Status status)
+                            {
+                              results[i].status = std::move(status);
+                              results[i].latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                                  std::chrono::steady_clock::now() - call->sent);
+                              if (done)
+                                done(results[i], &call->context);
+                              // Notify under the lock: the caller's stack frame
+                              // goes away as soon as it sees zero.
+                              std::lock_guard<std::mutex> lock(mu);
+                              if (--remaining == 0)
+                                cv.notify_all();
+                            });
+  }
+
+  std::unique_lock<std::mutex> lock(mu);
+  cv.wait(lock, [&]
+          { return remaining == 0; });
+  return results;
+}
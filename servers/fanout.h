@@ -0,0 +1,32 @@
+#pragma once
+#include "channel_registry.h"
+#include "data.grpc.pb.h"
+
+#include <grpcpp/grpcpp.h>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Outcome of one neighbor's call in a fan_out().
+struct FanoutResult
+{
+  std::string neighbor;
+  grpc::Status status;
+  std::chrono::microseconds latency{0};
+  bool sent = false; // false when the neighbor had no channel and no call went out
+};
+
+// Runs on a call's context before it goes out (traces, wait-for-ready).
+using FanoutPrepare = std::function<void(grpc::ClientContext &context)>;
+// Runs on gRPC's completion thread while the finished context is still alive,
+// so trailers can be read; context is null when the call never went out.
+using FanoutDone = std::function<void(const FanoutResult &result, const grpc::ClientContext *context)>;
+
+// Sends `request` to every neighbor at once through the callback API, each
+// call with its edge's deadline, and blocks until all of them have completed.
+// Total latency is that of the slowest neighbor instead of the sum. Neighbors
+// without a channel fail with UNAVAILABLE without a call.
+std::vector<FanoutResult> fan_out(ChannelRegistry &channels, const std::vector<std::string> &neighbors,
+                                  const dataservice::DataRequest &request, const FanoutPrepare &prepare,
+                                  const FanoutDone &done);
@@ -0,0 +1,84 @@
+#include "hash_ring.h"
+#include "dedup.h"
+
+#include <algorithm>
+#include <set>
+
+HashRing::HashRing(const PlacementOptions &options)
+{
+  for (const auto &[node, weight] : options.weights)
+  {
+    int index = static_cast<int>(nodes_.size());
+    nodes_.push_back(node);
+    for (int i = 0; i < weight * options.vnodes; ++i)
+      points_.emplace_back(payload_fingerprint(node + "#" + std::to_string(i)), index);
+  }
+  std::sort(points_.begin(), points_.end());
+}
+
+const std::string &HashRing::owner(uint64_t key) const
+{
+  static const std::string none;
+  if (points_.empty())
+    return none;
+
+  // First point at or after the key, wrapping past the top of the ring.
+  auto it = std::lower_bound(points_.begin(), points_.end(), std::make_pair(key, 0));
+  if (it == points_.end())
+    it = points_.begin();
+  return nodes_[it->second];
+}
+
+const std::string &HashRing::owner(const std::string &payload) const
+{
+  return owner(payload_fingerprint(payload));
+}
+
+namespace
+{
+  bool reaches(const RoutingConfig &config, const std::string &from, const std::string &target,
+               std::set<std::string> &visited)
+  {
+    if (from == target)
+      return true;
+    if (!visited.insert(from).second)
+      return false;
+
+    auto it = config.routing_table.find(from);
+    if (it == config.routing_table.end())
+      return false;
+    for (const auto &next : it->second)
+    {
+      if (reaches(config, next, target, visited))
+        return true;
+    }
+    return false;
+  }
+}
+
+std::unordered_map<std::string, std::string> owner_routes(const RoutingConfig &config)
+{
+  std::unordered_map<std::string, std::string> routes;
+  for (const auto &[owner, weight] : config.placement.weights)
+  {
+    if (owner == config.node_name)
+      continue;
+
+    // Prefer the owner itself, then neighbors in routing_table order.
+    std::string via;
+    for (const auto &neighbor : config.neighbors)
+    {
+      if (neighbor == owner)
+        via = neighbor;
+    }
+    for (const auto &neighbor : config.neighbors)
+    {
+      std::set<std::string> visited{config.node_name};
+      if (via.empty() && reaches(config, neighbor, owner, visited))
+        via = neighbor;
+    }
+    if (!via.empty())
+      routes[owner] = via;
+  }
+  return routes;
+}
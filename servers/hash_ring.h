@@ -0,0 +1,32 @@
+#pragma once
+#include "config_loader.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Consistent-hash ring over the storage nodes in placement.weights. Each node
+// gets weight * vnodes points, so a record's home is stable across processes
+// and adding a node only moves the records that land on its points.
+class HashRing
+{
+public:
+  explicit HashRing(const PlacementOptions &options);
+
+  bool empty() const { return points_.empty(); }
+
+  // Home node of a record; `key` is its payload_fingerprint(). Empty ring: "".
+  const std::string &owner(uint64_t key) const;
+  const std::string &owner(const std::string &payload) const;
+
+private:
+  std::vector<std::string> nodes_;
+  std::vector<std::pair<uint64_t, int>> points_; // sorted (hash, node index)
+};
+
+// For every ring node, the neighbor of `config.node_name` whose subtree in
+// routing_table reaches it (the neighbor itself if it is the node). Owners
+// that are this node or unreachable from it have no entry.
+std::unordered_map<std::string, std::string> owner_routes(const RoutingConfig &config);
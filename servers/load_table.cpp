@@ -0,0 +1,133 @@
+#include "load_table.h"
+#include "region_lock.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+int find_load_slot(const SharedData &data, const std::string &name)
+{
+  int count = data.num_neighbors.load(std::memory_order_acquire);
+  for (int i = 0; i < count; ++i)
+  {
+    if (strncmp(data.loads[i].name, name.c_str(), MAX_NAME_LEN) == 0)
+      return i;
+  }
+  return -1;
+}
+
+void add_load(SharedData &data, const std::string &name, int records)
+{
+  int slot = find_load_slot(data, name);
+  if (slot >= 0)
+  {
+    data.loads[slot].load_count.fetch_add(records, std::memory_order_relaxed);
+    return;
+  }
+
+  RegionLock lock(data, LOCK_SITE_LOAD_REGISTER);
+  slot = find_load_slot(data, name); // registered while we waited?
+  if (slot >= 0)
+  {
+    data.loads[slot].load_count.fetch_add(records, std::memory_order_relaxed);
+  }
+  else
+  {
+    int count = data.num_neighbors.load(std::memory_order_relaxed);
+    if (count < MAX_NEIGHBORS)
+    {
+      strncpy(data.loads[count].name, name.c_str(), MAX_NAME_LEN - 1);
+      data.loads[count].name[MAX_NAME_LEN - 1] = '\0';
+      data.loads[count].load_count.store(records, std::memory_order_relaxed);
+      data.num_neighbors.store(count + 1, std::memory_order_release);
+    }
+  }
+}
+
+int select_least_loaded(const SharedData &data, const int *pending)
+{
+  int count = data.num_neighbors.load(std::memory_order_acquire);
+  int best = -1;
+  int min_load = INT_MAX;
+  for (int i = 0; i < count; ++i)
+  {
+    int load = data.loads[i].load_count.load(std::memory_order_relaxed) + (pending ? pending[i] : 0);
+    if (load < min_load)
+    {
+      min_load = load;
+      best = i;
+    }
+  }
+  return best;
+}
+
+int select_round_robin(const SharedData &data, std::atomic<unsigned> &cursor)
+{
+  int count = data.num_neighbors.load(std::memory_order_acquire);
+  if (count == 0)
+    return -1;
+  return static_cast<int>(cursor.fetch_add(1, std::memory_order_relaxed) % count);
+}
+
+namespace
+{
+  uint64_t p2c_score(const SharedLoad &load)
+  {
+    uint64_t latency = load.latency_ewma_us.load(std::memory_order_relaxed);
+    int outstanding = std::max(0, load.outstanding.load(std::memory_order_relaxed));
+    return (latency + 1) * static_cast<uint64_t>(outstanding + 1);
+  }
+}
+
+int select_p2c(const SharedData &data, uint64_t random)
+{
+  return select_p2c(data.loads, data.num_neighbors.load(std::memory_order_acquire), random);
+}
+
+int select_p2c(const SharedLoad *loads, int count, uint64_t random)
+{
+  if (count <= 1)
+    return count - 1;
+
+  int first = static_cast<int>(random % count);
+  int second = static_cast<int>((random >> 32) % (count - 1));
+  if (second >= first)
+    second++;
+  return p2c_score(loads[second]) < p2c_score(loads[first]) ? second : first;
+}
+
+void begin_requests(SharedData &data, int slot, int records)
+{
+  begin_requests(data.loads[slot], records);
+}
+
+void begin_requests(SharedLoad &load, int records)
+{
+  load.outstanding.fetch_add(records, std::memory_order_relaxed);
+}
+
+void end_requests(SharedData &data, int slot, int records, std::chrono::microseconds latency, bool ok)
+{
+  end_requests(data.loads[slot], records, latency, ok);
+}
+
+void end_requests(SharedLoad &load, int records, std::chrono::microseconds latency, bool ok)
+{
+  load.outstanding.fetch_sub(records, std::memory_order_relaxed);
+  if (!ok)
+    latency = std::max(latency, std::chrono::microseconds(std::chrono::seconds(1)));
+
+  // EWMA with alpha = 1/8; the first sample seeds it.
+  uint32_t sample = static_cast<uint32_t>(std::max<int64_t>(1, latency.count()));
+  uint32_t current = load.latency_ewma_us.load(std::memory_order_relaxed);
+  uint32_t next;
+  do
+  {
+    next = current == 0 ? sample : current + (static_cast<int64_t>(sample) - current) / 8;
+  } while (!load.latency_ewma_us.compare_exchange_weak(current, next, std::memory_order_relaxed));
+}
+
+void cancel_requests(SharedData &data, int slot, int records)
+{
+  data.loads[slot].outstanding.fetch_sub(records, std::memory_order_relaxed);
+}
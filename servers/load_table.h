@@ -0,0 +1,38 @@
+#pragma once
+#include "shared_data.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+// Wait-free access to the shared per-neighbor load counters. Only adding a
+// new name takes the region's load_mutex; counting and selection never do.
+
+// Index of name's load slot, or -1 if it is not registered.
+int find_load_slot(const SharedData &data, const std::string &name);
+
+// Adds `records` to name's counter, registering the name under the region's
+// load_mutex the first time it is seen.
+void add_load(SharedData &data, const std::string &name, int records);
+
+// Slot with the lowest load_count (+ pending[i] when given), or -1 if empty.
+int select_least_loaded(const SharedData &data, const int *pending = nullptr);
+
+// Next slot in rotation, advancing the caller's cursor; -1 if empty.
+int select_round_robin(const SharedData &data, std::atomic<unsigned> &cursor);
+
+// Power of two choices: of two distinct slots picked from `random`, the one
+// with the lower latency EWMA x (outstanding + 1); -1 if empty. Neighbors
+// without a latency sample yet score as the fastest so they get probed.
+int select_p2c(const SharedData &data, uint64_t random);
+int select_p2c(const SharedLoad *loads, int count, uint64_t random);
+
+// `records` were assigned to slot's neighbor / came back from it after
+// `latency`. Failed forwards must end too so outstanding never leaks; they
+// are sampled as at least one second so p2c steers away from the neighbor.
+void begin_requests(SharedData &data, int slot, int records);
+void begin_requests(SharedLoad &load, int records);
+void end_requests(SharedData &data, int slot, int records, std::chrono::microseconds latency, bool ok);
+void end_requests(SharedLoad &load, int records, std::chrono::microseconds latency, bool ok);
+// Takes back `records` assigned to slot's neighbor that were never sent.
+void cancel_requests(SharedData &data, int slot, int records);
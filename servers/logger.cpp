@@ -0,0 +1,228 @@
+#include "logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <pthread.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  constexpr size_t kSlots = 4096; // lines buffered per thread before dropping
+
+  // Single-producer (the owning thread) / single-consumer (the drainer) queue.
+  struct ThreadBuffer
+  {
+    struct Entry
+    {
+      LogLevel level;
+      std::string text;
+    };
+
+    std::atomic<size_t> head{0};
+    std::atomic<size_t> tail{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> retired{false}; // owning thread has exited
+    Entry entries[kSlots];
+  };
+
+  struct LoggerState
+  {
+    std::atomic<int> level{static_cast<int>(LogLevel::Info)};
+    std::atomic<int> sample_every{1};
+
+    std::mutex registry_mu;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    // Bumped in a forked child so threads there register fresh buffers.
+    std::atomic<unsigned> generation{0};
+    bool drainer_running = false; // guarded by registry_mu
+
+    std::mutex drain_mu; // one drain at a time
+  };
+
+  // Leaked on purpose: logging must keep working while statics are destroyed.
+  LoggerState &state()
+  {
+    static LoggerState *logger = new LoggerState;
+    return *logger;
+  }
+
+  struct BufferHolder
+  {
+    std::shared_ptr<ThreadBuffer> buffer;
+    unsigned generation = 0;
+    ~BufferHolder()
+    {
+      if (buffer)
+        buffer->retired.store(true, std::memory_order_release);
+    }
+  };
+  thread_local BufferHolder tls_buffer;
+
+  size_t drain_once()
+  {
+    LoggerState &logger = state();
+    std::lock_guard<std::mutex> drain_lock(logger.drain_mu);
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+      std::lock_guard<std::mutex> lock(logger.registry_mu);
+      buffers = logger.buffers;
+    }
+
+    std::string out;
+    std::string err;
+    size_t lines = 0;
+    for (auto &buffer : buffers)
+    {
+      size_t tail = buffer->tail.load(std::memory_order_relaxed);
+      size_t head = buffer->head.load(std::memory_order_acquire);
+      for (; tail != head; ++tail, ++lines)
+      {
+        ThreadBuffer::Entry &entry = buffer->entries[tail % kSlots];
+        std::string &sink = entry.level >= LogLevel::Error ? err : out;
+        sink += entry.text;
+        sink += '\n';
+        entry.text.clear();
+      }
+      buffer->tail.store(tail, std::memory_order_release);
+
+      uint64_t dropped = buffer->dropped.exchange(0, std::memory_order_relaxed);
+      if (dropped > 0)
+        err += "[Log] ⚠️ " + std::to_string(dropped) + " line(s) dropped: buffer full\n";
+    }
+
+    if (!out.empty())
+    {
+      fwrite(out.data(), 1, out.size(), stdout);
+      fflush(stdout);
+    }
+    if (!err.empty())
+    {
+      fwrite(err.data(), 1, err.size(), stderr);
+      fflush(stderr);
+    }
+
+    std::lock_guard<std::mutex> lock(logger.registry_mu);
+    auto &all = logger.buffers;
+    for (size_t i = 0; i < all.size();)
+    {
+      ThreadBuffer &buffer = *all[i];
+      if (buffer.retired.load(std::memory_order_acquire) &&
+          buffer.tail.load(std::memory_order_relaxed) == buffer.head.load(std::memory_order_acquire))
+      {
+        all[i] = all.back();
+        all.pop_back();
+      }
+      else
+      {
+        ++i;
+      }
+    }
+    return lines;
+  }
+
+  void drainer_loop()
+  {
+    while (true)
+    {
+      if (drain_once() == 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+  }
+
+  void before_fork()
+  {
+    state().drain_mu.lock();
+    state().registry_mu.lock();
+  }
+
+  void after_fork_parent()
+  {
+    state().registry_mu.unlock();
+    state().drain_mu.unlock();
+  }
+
+  // The drainer thread does not survive fork(); lines still buffered belong
+  // to the parent, which prints them. Start over with no buffers.
+  void after_fork_child()
+  {
+    LoggerState &logger = state();
+    logger.buffers.clear();
+    logger.drainer_running = false;
+    logger.generation.fetch_add(1);
+    logger.registry_mu.unlock();
+    logger.drain_mu.unlock();
+  }
+
+  // Caller holds registry_mu.
+  void start_drainer_locked()
+  {
+    LoggerState &logger = state();
+    if (logger.drainer_running)
+      return;
+    logger.drainer_running = true;
+
+    static std::once_flag hooks;
+    std::call_once(hooks, []
+                   {
+                     pthread_atfork(before_fork, after_fork_parent, after_fork_child);
+                     std::atexit(flush_logs); });
+    std::thread(drainer_loop).detach();
+  }
+
+  ThreadBuffer &local_buffer()
+  {
+    LoggerState &logger = state();
+    unsigned generation = logger.generation.load(std::memory_order_acquire);
+    if (!tls_buffer.buffer || tls_buffer.generation != generation)
+    {
+      tls_buffer.buffer = std::make_shared<ThreadBuffer>();
+      tls_buffer.generation = generation;
+      std::lock_guard<std::mutex> lock(logger.registry_mu);
+      logger.buffers.push_back(tls_buffer.buffer);
+      start_drainer_locked();
+    }
+    return *tls_buffer.buffer;
+  }
+}
+
+void configure_logging(const LoggingOptions &options)
+{
+  state().level.store(static_cast<int>(options.level), std::memory_order_relaxed);
+  state().sample_every.store(options.sample_every, std::memory_order_relaxed);
+}
+
+void flush_logs()
+{
+  while (drain_once() > 0)
+  {
+  }
+}
+
+bool log_enabled(LogLevel level)
+{
+  return static_cast<int>(level) >= state().level.load(std::memory_order_relaxed);
+}
+
+bool log_sample(std::atomic<unsigned> &site_counter)
+{
+  int every = state().sample_every.load(std::memory_order_relaxed);
+  return every <= 1 || site_counter.fetch_add(1, std::memory_order_relaxed) % every == 0;
+}
+
+void log_write(LogLevel level, std::string line)
+{
+  ThreadBuffer &buffer = local_buffer();
+  size_t head = buffer.head.load(std::memory_order_relaxed);
+  if (head - buffer.tail.load(std::memory_order_acquire) >= kSlots)
+  {
+    buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer.entries[head % kSlots] = {level, std::move(line)};
+  buffer.head.store(head + 1, std::memory_order_release);
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "config_loader.h"
+
+#include <atomic>
+#include <sstream>
+#include <string>
+
+// Asynchronous leveled logging. Each thread formats into its own lock-free
+// buffer and a background thread writes the lines out in batches, so RPC
+// handlers never block on the terminal. Levels below MINI2_LOG_LEVEL are
+// compiled out; the rest are filtered at runtime by logging.level.
+//
+//   LOG_INFO("[Node " << name << "] Listening on " << address);
+//   LOG_SAMPLED(LogLevel::Info, "[Node " << name << "] Received: " << payload);
+
+#ifndef MINI2_LOG_LEVEL
+#define MINI2_LOG_LEVEL 0
+#endif
+
+void configure_logging(const LoggingOptions &options);
+
+// Writes out everything buffered so far. Also runs at exit().
+void flush_logs();
+
+bool log_enabled(LogLevel level);
+void log_write(LogLevel level, std::string line);
+
+// True for one call in logging.sample_every on the given call-site counter.
+bool log_sample(std::atomic<unsigned> &site_counter);
+
+#define MINI2_LOG(level, expr)                                   \
+  do                                                             \
+  {                                                              \
+    if constexpr (static_cast<int>(level) >= MINI2_LOG_LEVEL)    \
+    {                                                            \
+      if (log_enabled(level))                                    \
+      {                                                          \
+        std::ostringstream mini2_log_stream;                     \
+        mini2_log_stream << expr;                                \
+        log_write(level, mini2_log_stream.str());                \
+      }                                                          \
+    }                                                            \
+  } while (0)
+
+#define LOG_DEBUG(expr) MINI2_LOG(LogLevel::Debug, expr)
+#define LOG_INFO(expr) MINI2_LOG(LogLevel::Info, expr)
+#define LOG_WARN(expr) MINI2_LOG(LogLevel::Warn, expr)
+#define LOG_ERROR(expr) MINI2_LOG(LogLevel::Error, expr)
+
+// For per-message events: only 1 in logging.sample_every calls from this call
+// site is formatted and written.
+#define LOG_SAMPLED(level, expr)                                   \
+  do                                                               \
+  {                                                                \
+    if constexpr (static_cast<int>(level) >= MINI2_LOG_LEVEL)      \
+    {                                                              \
+      static std::atomic<unsigned> mini2_log_site{0};              \
+      if (log_enabled(level) && log_sample(mini2_log_site))        \
+        MINI2_LOG(level, expr);                                    \
+    }                                                              \
+  } while (0)
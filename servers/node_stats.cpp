@@ -0,0 +1,172 @@
+#include "node_stats.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <sys/mman.h>
+
+StatsRecorder::StatsRecorder(const RoutingConfig &config)
+    : node_(config.node_name), started_(std::chrono::steady_clock::now())
+{
+  for (const auto &neighbor : config.neighbors)
+  {
+    if (static_cast<int>(neighbors_.size()) < MAX_NEIGHBORS)
+      neighbors_.push_back(neighbor);
+  }
+
+  void *memory = mmap(nullptr, sizeof(Counters), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED)
+  {
+    perror("mmap");
+    exit(1);
+  }
+  counters_ = new (memory) Counters(); // zero-filled by mmap
+}
+
+StatsRecorder::~StatsRecorder()
+{
+  munmap(counters_, sizeof(Counters));
+}
+
+void StatsRecorder::received(uint64_t records)
+{
+  counters_->received.fetch_add(records, std::memory_order_relaxed);
+}
+
+void StatsRecorder::processed(uint64_t records)
+{
+  counters_->processed.fetch_add(records, std::memory_order_relaxed);
+}
+
+void StatsRecorder::duplicates(uint64_t records)
+{
+  counters_->duplicates.fetch_add(records, std::memory_order_relaxed);
+}
+
+void StatsRecorder::forwarded(const std::string &neighbor, uint64_t records, bool ok)
+{
+  for (size_t i = 0; i < neighbors_.size(); ++i)
+  {
+    if (neighbors_[i] == neighbor)
+    {
+      (ok ? counters_->forwarded : counters_->failed)[i].fetch_add(records, std::memory_order_relaxed);
+      return;
+    }
+  }
+}
+
+int StatsRecorder::bucket_for(uint64_t us)
+{
+  if (us < 16)
+    return static_cast<int>(us);
+  int exponent = 63 - __builtin_clzll(us); // >= 4
+  int sub = static_cast<int>((us >> (exponent - 3)) & 7);
+  return std::min(16 + (exponent - 4) * 8 + sub, kLatencyBuckets - 1);
+}
+
+uint64_t StatsRecorder::bucket_floor(int bucket)
+{
+  if (bucket < 16)
+    return static_cast<uint64_t>(bucket);
+  int exponent = (bucket - 16) / 8 + 4;
+  uint64_t sub = static_cast<uint64_t>((bucket - 16) % 8);
+  return (uint64_t(8) + sub) << (exponent - 3);
+}
+
+void StatsRecorder::observe_latency(std::chrono::steady_clock::duration elapsed)
+{
+  uint64_t us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+  counters_->latency[bucket_for(us)].fetch_add(1, std::memory_order_relaxed);
+
+  uint64_t max = counters_->latency_max_us.load(std::memory_order_relaxed);
+  while (us > max && !counters_->latency_max_us.compare_exchange_weak(max, us, std::memory_order_relaxed))
+  {
+  }
+}
+
+void StatsRecorder::add_queue(const std::string &name, std::function<int64_t()> depth)
+{
+  std::lock_guard<std::mutex> lock(queues_mu_);
+  queues_.emplace_back(name, std::move(depth));
+}
+
+uint64_t StatsRecorder::processed_count() const
+{
+  return counters_->processed.load(std::memory_order_relaxed);
+}
+
+uint64_t StatsRecorder::duplicate_count() const
+{
+  return counters_->duplicates.load(std::memory_order_relaxed);
+}
+
+uint64_t StatsRecorder::forwarded_count() const
+{
+  uint64_t total = 0;
+  for (size_t i = 0; i < neighbors_.size(); ++i)
+    total += counters_->forwarded[i].load(std::memory_order_relaxed);
+  return total;
+}
+
+uint64_t StatsRecorder::percentile_us(double q, uint64_t samples) const
+{
+  uint64_t rank = static_cast<uint64_t>(q * (samples - 1));
+  uint64_t seen = 0;
+  for (int i = 0; i < kLatencyBuckets; ++i)
+  {
+    seen += counters_->latency[i].load(std::memory_order_relaxed);
+    if (seen > rank)
+      return bucket_floor(i);
+  }
+  return counters_->latency_max_us.load(std::memory_order_relaxed);
+}
+
+void StatsRecorder::fill(dataservice::NodeStats *stats) const
+{
+  stats->set_node(node_);
+  stats->set_uptime_ms(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                 std::chrono::steady_clock::now() - started_)
+                                                 .count()));
+  stats->set_received(counters_->received.load(std::memory_order_relaxed));
+  stats->set_processed(processed_count());
+  stats->set_duplicates(duplicate_count());
+
+  uint64_t forwarded = 0;
+  uint64_t failed = 0;
+  for (size_t i = 0; i < neighbors_.size(); ++i)
+  {
+    auto *neighbor = stats->add_neighbors();
+    neighbor->set_neighbor(neighbors_[i]);
+    neighbor->set_forwarded(counters_->forwarded[i].load(std::memory_order_relaxed));
+    neighbor->set_failed(counters_->failed[i].load(std::memory_order_relaxed));
+    forwarded += neighbor->forwarded();
+    failed += neighbor->failed();
+  }
+  stats->set_forwarded(forwarded);
+  stats->set_failed(failed);
+
+  {
+    std::lock_guard<std::mutex> lock(queues_mu_);
+    for (const auto &[name, depth] : queues_)
+    {
+      auto *queue = stats->add_queues();
+      queue->set_name(name);
+      queue->set_depth(depth());
+    }
+  }
+
+  uint64_t samples = 0;
+  for (int i = 0; i < kLatencyBuckets; ++i)
+    samples += counters_->latency[i].load(std::memory_order_relaxed);
+
+  auto *latency = stats->mutable_latency();
+  latency->set_samples(samples);
+  if (samples > 0)
+  {
+    latency->set_p50_us(percentile_us(0.50, samples));
+    latency->set_p90_us(percentile_us(0.90, samples));
+    latency->set_p99_us(percentile_us(0.99, samples));
+    latency->set_max_us(counters_->latency_max_us.load(std::memory_order_relaxed));
+  }
+}
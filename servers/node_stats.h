@@ -0,0 +1,67 @@
+#pragma once
+#include "config_loader.h"
+#include "data.pb.h"
+#include "shared_data.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Live counters behind the GetStats RPC. The counters live in an anonymous
+// shared mapping, so processes forked after construction (node B's scatter
+// workers) update the same numbers the parent reports. All updates are
+// relaxed atomic adds.
+class StatsRecorder
+{
+public:
+  explicit StatsRecorder(const RoutingConfig &config);
+  ~StatsRecorder();
+
+  void received(uint64_t records = 1);
+  void processed(uint64_t records = 1);
+  void duplicates(uint64_t records = 1);
+  void forwarded(const std::string &neighbor, uint64_t records, bool ok);
+  void observe_latency(std::chrono::steady_clock::duration elapsed);
+
+  // Sampled on every GetStats call.
+  void add_queue(const std::string &name, std::function<int64_t()> depth);
+
+  uint64_t processed_count() const;
+  uint64_t duplicate_count() const;
+  uint64_t forwarded_count() const;
+
+  void fill(dataservice::NodeStats *stats) const;
+
+private:
+  // Latency histogram in microseconds: exact below 16 us, then 8 linear
+  // sub-buckets per power of two (<= 12.5% error).
+  static constexpr int kLatencyBuckets = 16 + 8 * 44;
+
+  struct Counters
+  {
+    std::atomic<uint64_t> received;
+    std::atomic<uint64_t> processed;
+    std::atomic<uint64_t> duplicates;
+    std::atomic<uint64_t> forwarded[MAX_NEIGHBORS];
+    std::atomic<uint64_t> failed[MAX_NEIGHBORS];
+    std::atomic<uint64_t> latency[kLatencyBuckets];
+    std::atomic<uint64_t> latency_max_us;
+  };
+
+  static int bucket_for(uint64_t us);
+  static uint64_t bucket_floor(int bucket);
+  uint64_t percentile_us(double q, uint64_t samples) const;
+
+  std::string node_;
+  std::vector<std::string> neighbors_; // index = slot in forwarded/failed
+  std::chrono::steady_clock::time_point started_;
+  Counters *counters_;
+
+  mutable std::mutex queues_mu_;
+  std::vector<std::pair<std::string, std::function<int64_t()>>> queues_;
+};
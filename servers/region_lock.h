@@ -0,0 +1,83 @@
+#pragma once
+#include "shared_data.h"
+
+#include <cerrno>
+#include <pthread.h>
+
+#ifdef MINI2_LOCK_PROFILE
+#include <chrono>
+#endif
+
+// Makes `mutex`, which lives in the segment, robust and process-shared.
+inline void init_region_mutex(pthread_mutex_t &mutex)
+{
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+  pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+  pthread_mutex_init(&mutex, &attr);
+  pthread_mutexattr_destroy(&attr);
+}
+
+// Scoped lock on a region's load_mutex. A holder that died mid-way leaves the
+// mutex EOWNERDEAD; the next locker marks it consistent and carries on, since
+// a half-registered name lies beyond num_neighbors and is simply rewritten.
+// Built with MINI2_LOCK_PROFILE, it also records how long the caller waited
+// for and then held the mutex into data.lock_profile[site].
+class RegionLock
+{
+public:
+#ifdef MINI2_LOCK_PROFILE
+  RegionLock(SharedData &data, LockSite site)
+      : mutex_(data.load_mutex), histogram_(&data.lock_profile[site])
+  {
+    auto start = Clock::now();
+    lock(mutex_);
+    acquired_ = Clock::now();
+    record(histogram_->wait_buckets, histogram_->wait_ns_total, histogram_->wait_ns_max, acquired_ - start);
+  }
+
+  ~RegionLock()
+  {
+    auto held = Clock::now() - acquired_;
+    pthread_mutex_unlock(&mutex_);
+    record(histogram_->hold_buckets, histogram_->hold_ns_total, histogram_->hold_ns_max, held);
+    histogram_->acquisitions.fetch_add(1, std::memory_order_relaxed);
+  }
+#else
+  RegionLock(SharedData &data, LockSite) : mutex_(data.load_mutex) { lock(mutex_); }
+  ~RegionLock() { pthread_mutex_unlock(&mutex_); }
+#endif
+
+  RegionLock(const RegionLock &) = delete;
+  RegionLock &operator=(const RegionLock &) = delete;
+
+private:
+  static void lock(pthread_mutex_t &mutex)
+  {
+    if (pthread_mutex_lock(&mutex) == EOWNERDEAD)
+      pthread_mutex_consistent(&mutex);
+  }
+
+  pthread_mutex_t &mutex_;
+
+#ifdef MINI2_LOCK_PROFILE
+  using Clock = std::chrono::steady_clock;
+
+  static void record(std::atomic<uint64_t> *buckets, std::atomic<uint64_t> &total,
+                     std::atomic<uint64_t> &max, Clock::duration elapsed)
+  {
+    uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    int bucket = ns == 0 ? 0 : 63 - __builtin_clzll(ns);
+    buckets[bucket < LOCK_HIST_BUCKETS ? bucket : LOCK_HIST_BUCKETS - 1].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t seen = max.load(std::memory_order_relaxed);
+    while (ns > seen && !max.compare_exchange_weak(seen, ns, std::memory_order_relaxed))
+    {
+    }
+  }
+
+  LockHistogram *histogram_;
+  Clock::time_point acquired_;
+#endif
+};
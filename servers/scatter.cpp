@@ -1,16 +1,32 @@
 #include "scatter.h"
 #include "config_loader.h"
+#include "channel_registry.h"
+#include "batcher.h"
+#include "collision_record.h"
 #include "data.grpc.pb.h"
 #include "shared_data.h"
+#include "load_table.h"
+#include "worker_ring.h"
+#include "work_stealing_pool.h"
+#include "logger.h"
+#include "credits.h"
+#include "fanout.h"
 
 #include <grpcpp/grpcpp.h>
 #include <iostream>
 #include <vector>
-#include <semaphore.h>
 #include <unistd.h>
 #include <sys/wait.h>
 #include <csignal>
 #include <cstring>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <algorithm>
+#include <random>
+#include <sys/mman.h>
 
 using dataservice::DataRequest;
 using dataservice::DataService;
@@ -20,112 +36,299 @@ using grpc::ClientContext;
 using grpc::Status;
 
 extern SharedData *shared_data;
-extern sem_t *shared_mutex;
 
 namespace
 {
   struct Worker
   {
-    int write_fd;
+    WorkerRing *ring;
     pid_t pid;
+    std::unique_ptr<std::mutex> push_mutex; // one producer per ring
   };
 
   std::vector<Worker> workers;
-  int current_worker = 0;
+  std::atomic<unsigned> current_worker{0};
+
+  // Per-worker queued records and service-time EWMA for dispatch "p2c" and
+  // backpressure, in memory shared with the forked workers, which report
+  // their own progress.
+  SharedLoad *worker_loads = nullptr;
+  int worker_load_count = 0;
 
   RoutingConfig g_config;
+  StatsRecorder *g_stats = nullptr;
+  SeenSummary *g_summary = nullptr;
+
+  // Created inside each worker process (gRPC channels must not cross fork()),
+  // or once in B itself and shared by every pool thread in threads mode.
+  std::unique_ptr<ChannelRegistry> g_channels;
+  std::unique_ptr<BatchForwarder> g_batcher; // null unless batching is enabled
+  std::unique_ptr<WorkStealingPool> g_pool;  // threads mode only
+  std::unique_ptr<EdgeCredits> g_credits;    // null unless backpressure is enabled
+  std::unique_ptr<OverloadRetries> g_retries; // null unless backpressure is enabled
 
-  void forward_to_neighbors(const std::string &payload)
+  void record_load(const std::string &neighbor, int records)
   {
-    for (const auto &neighbor : g_config.neighbors)
+    if (shared_data)
+      add_load(*shared_data, neighbor, records);
+  }
+
+  void record_result(const std::string &neighbor, int records, bool ok)
+  {
+    if (g_stats)
+      g_stats->forwarded(neighbor, records, ok);
+    if (ok)
+      record_load(neighbor, records);
+  }
+
+  // Wait for the (already established) connection rather than failing fast;
+  // the edge's deadline_ms still bounds the call.
+  void prepare_call(ClientContext &context, const TraceContext *trace)
+  {
+    context.set_wait_for_ready(true);
+    if (trace)
+      attach_traces(context, {{0, *trace}});
+  }
+
+  void finish_call(const std::string &neighbor, const DataRequest &request, const Status &status,
+                   const ClientContext *context)
+  {
+    if (g_credits)
+      g_credits->release(neighbor, 1, context);
+    if (g_summary)
+      g_summary->absorb(context);
+    if (!context)
+      return; // no channel to this neighbor
+    if (status.ok())
     {
-      std::string address = g_config.address_map[neighbor];
-      auto channel = grpc::CreateChannel(address, grpc::InsecureChannelCredentials());
+      LOG_SAMPLED(LogLevel::Debug, "[Scatter] ✅ Successfully sent to " << neighbor);
+    }
+    else
+    {
+      LOG_ERROR("[Scatter] ❌ Failed to send to " << neighbor << ": " << status.error_message());
+    }
+    // 🔐 Update shared memory load tracking
+    record_result(neighbor, 1, status.ok());
+    // B acked the record long ago; an overloaded neighbor gets it again later.
+    if (g_retries)
+      g_retries->retry(neighbor, request, status);
+  }
 
-      if (!channel->WaitForConnected(gpr_time_add(gpr_now(GPR_CLOCK_REALTIME), gpr_time_from_seconds(2, GPR_TIMESPAN))))
-      {
-        std::cerr << "[Scatter] ❌ Timeout while connecting to " << neighbor << " at " << address << std::endl;
-        continue;
-      }
+  void forward_to_neighbor(const std::string &neighbor, const DataRequest &request, const TraceContext *trace)
+  {
+    DataService::Stub *stub = g_channels->stub(neighbor);
+    if (!stub)
+    {
+      finish_call(neighbor, request, Status::OK, nullptr);
+      return;
+    }
 
-      std::unique_ptr<DataService::Stub> stub = DataService::NewStub(channel);
+    Empty response;
+    ClientContext context;
+    g_channels->set_deadline(context, neighbor);
+    prepare_call(context, trace);
 
-      DataRequest request;
-      request.set_payload(payload);
-      Empty response;
-      ClientContext context;
+    LOG_SAMPLED(LogLevel::Debug, "[Scatter] 🔁 Sending to " << neighbor << " at " << g_channels->address(neighbor));
 
-      std::cout << "[Scatter] 🔁 Sending to " << neighbor << " at " << address << std::endl;
+    Status status = stub->SendData(&context, request, &response);
+    finish_call(neighbor, request, status, &context);
+  }
 
-      Status status = stub->SendData(&context, request, &response);
-      if (status.ok())
-      {
-        std::cout << "[Scatter] ✅ Successfully sent to " << neighbor << std::endl;
+  // Sends to all neighbors concurrently; a slow child no longer holds up the
+  // others, and the record is done when the slowest one answers.
+  void forward_to_neighbors(const DataRequest &request, const TraceContext *trace)
+  {
+    fan_out(
+        *g_channels, g_config.neighbors, request,
+        [trace](ClientContext &context)
+        { prepare_call(context, trace); },
+        [&request](const FanoutResult &result, const ClientContext *context)
+        { finish_call(result.neighbor, request, result.status, context); });
+  }
 
-        // 🔐 Update shared memory load tracking
-        if (shared_mutex && shared_data)
-        {
-          sem_wait(shared_mutex);
+  // Batched send; with retries on, the record is kept until its batch is
+  // acked in case the neighbor turns it away.
+  void add_to_batch(const std::string &neighbor, const DataRequest &request, const TraceContext *trace)
+  {
+    BatchForwarder::RecordDone done;
+    if (g_retries)
+      done = [neighbor, request](const Status &status)
+      { g_retries->retry(neighbor, request, status); };
+    g_batcher->add(neighbor, request, std::move(done), trace);
+  }
 
-          bool found = false;
-          for (int i = 0; i < shared_data->num_neighbors; ++i)
-          {
-            if (strcmp(shared_data->loads[i].name, neighbor.c_str()) == 0)
-            {
-              shared_data->loads[i].load_count++;
-              found = true;
-              break;
-            }
-          }
-
-          if (!found && shared_data->num_neighbors < MAX_NEIGHBORS)
+  // `senders` is the number of processes forwarding on each edge. Forked
+  // workers cannot share a gate, so each takes 1/senders of the window and
+  // of every grant, and together they stay within what the neighbor granted.
+  void create_forwarders(int senders)
+  {
+    g_channels = std::make_unique<ChannelRegistry>(g_config);
+    if (g_config.backpressure.enabled)
+      g_credits = std::make_unique<EdgeCredits>(g_config.neighbors, g_config.backpressure, senders);
+    if (g_config.batching.enabled)
+    {
+      g_batcher = std::make_unique<BatchForwarder>(
+          *g_channels, g_config.neighbors, g_config.batching,
+          [](const std::string &neighbor, int records, const Status &status, std::chrono::microseconds)
+          { record_result(neighbor, records, status.ok()); },
+          g_credits.get(), g_summary);
+    }
+    if (g_credits)
+    {
+      g_retries = std::make_unique<OverloadRetries>(
+          *g_credits, [](const std::string &neighbor, const DataRequest &request)
           {
-            strncpy(shared_data->loads[shared_data->num_neighbors].name, neighbor.c_str(), MAX_NAME_LEN - 1);
-            shared_data->loads[shared_data->num_neighbors].name[MAX_NAME_LEN - 1] = '\0';
-            shared_data->loads[shared_data->num_neighbors].load_count = 1;
-            shared_data->num_neighbors++;
-          }
-
-          sem_post(shared_mutex);
-        }
-      }
-      else
-      {
-        std::cerr << "[Scatter] ❌ Failed to send to " << neighbor << ": " << status.error_message() << std::endl;
-      }
+            if (g_batcher)
+              add_to_batch(neighbor, request, nullptr);
+            else
+              forward_to_neighbor(neighbor, request, nullptr); });
     }
   }
 
-  void worker_loop(int read_fd, int id)
+  // B has already acked these records, so workers wait for credits as long
+  // as it takes; the backlog this builds up is what makes B reject.
+  void await_credits(const std::vector<std::string> &neighbors)
+  {
+    if (g_credits)
+      g_credits->acquire(neighbors, 1, kWaitForever);
+  }
+
+  // Sends one record on to every neighbor, adding a worker hop to `trace`.
+  void dispatch(const DataRequest &request, TraceContext *trace, int64_t arrived_us)
+  {
+    if (trace)
+    {
+      trace->arrive("B.worker", arrived_us);
+    }
+    await_credits(g_config.neighbors);
+    if (trace)
+      trace->depart();
+
+    if (g_batcher)
+    {
+      for (const auto &neighbor : g_config.neighbors)
+        add_to_batch(neighbor, request, trace);
+    }
+    else
+    {
+      forward_to_neighbors(request, trace);
+    }
+  }
+
+  void worker_loop(WorkerRing &ring, int id, int workers)
+  {
+    create_forwarders(workers);
+
+    // Ring records are <uint16 trace length><encoded trace><DataRequest>.
+    auto handle = [id](const char *data, uint32_t length)
+    {
+      auto started = std::chrono::steady_clock::now();
+      int64_t arrived_us = trace_now_us();
+      uint16_t trace_length;
+      if (length < sizeof(trace_length))
+        return;
+      memcpy(&trace_length, data, sizeof(trace_length));
+      data += sizeof(trace_length);
+      length -= sizeof(trace_length);
+      if (length < trace_length)
+        return;
+
+      TraceContext trace;
+      bool traced = trace_length > 0 && decode_trace(std::string(data, trace_length), trace);
+      data += trace_length;
+      length -= trace_length;
+
+      DataRequest request;
+      if (!request.ParseFromArray(data, length))
+        return;
+      LOG_SAMPLED(LogLevel::Info, "[Worker " << id << "] received: " << payload_text(request));
+      dispatch(request, traced ? &trace : nullptr, arrived_us);
+
+      if (worker_loads)
+        end_requests(worker_loads[id], 1,
+                     std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started),
+                     true);
+    };
+
+    // Node B publishes serialized DataRequests into this worker's ring; drain
+    // whatever has accumulated and only block when it runs dry.
+    while (ring_wait(ring))
+      ring_drain(ring, handle);
+  }
+
+  // Threads mode: unbatched sends become one task per neighbor, so a slow
+  // neighbor ties up a single pool thread while the rest steal around it.
+  void submit_to_pool(const DataRequest &request, const TraceContext *trace)
   {
-    char buffer[1024];
-    while (true)
+    auto shared = std::make_shared<const DataRequest>(request);
+    if (g_batcher || trace)
     {
-      ssize_t bytes = read(read_fd, buffer, sizeof(buffer) - 1);
-      if (bytes > 0)
-      {
-        buffer[bytes] = '\0';
-        std::string payload(buffer);
-        std::cout << "[Worker " << id << "] received: " << payload << std::endl;
+      // Traced records stay on one task so the worker hop is measured once.
+      std::shared_ptr<TraceContext> traced;
+      if (trace)
+        traced = std::make_shared<TraceContext>(*trace);
+      g_pool->submit([shared, traced]
+                     {
+                       LOG_SAMPLED(LogLevel::Info, "[Worker " << WorkStealingPool::current_thread() << "] received: " << payload_text(*shared));
+                       dispatch(*shared, traced.get(), trace_now_us()); });
+      return;
+    }
 
-        forward_to_neighbors(payload);
-      }
+    for (const auto &neighbor : g_config.neighbors)
+    {
+      g_pool->submit([shared, neighbor]
+                     {
+                       await_credits({neighbor});
+                       forward_to_neighbor(neighbor, *shared, nullptr); });
     }
   }
 }
 
-void init_workers(int num_workers, const RoutingConfig &config)
+void init_workers(const RoutingConfig &config, StatsRecorder *stats, SeenSummary *summary)
 {
   g_config = config;
+  g_stats = stats;
+  g_summary = summary;
 
-  for (int i = 0; i < num_workers; ++i)
+  int num_workers = config.scatter.workers;
+  if (num_workers == 0)
+    num_workers = std::max(1u, std::thread::hardware_concurrency());
+
+  if (config.scatter.mode == ScatterMode::Threads)
+  {
+    create_forwarders(1);
+    g_pool = std::make_unique<WorkStealingPool>(num_workers);
+    if (stats)
+    {
+      stats->add_queue("scatter_pool_tasks", []
+                       { return g_pool ? g_pool->queued() : 0; });
+      if (g_batcher)
+        stats->add_queue("batch_buffered_records", []
+                         { return g_batcher ? g_batcher->buffered() : 0; });
+      if (g_retries)
+        stats->add_queue("overload_retry_records", []
+                         { return g_retries ? g_retries->queued() : 0; });
+    }
+    LOG_INFO("Initialized work-stealing pool with " << g_pool->size() << " threads.");
+    return;
+  }
+
+  if (config.scatter.dispatch == ScatterDispatch::PowerOfTwo || config.backpressure.enabled)
   {
-    int pipefd[2];
-    if (pipe(pipefd) == -1)
+    void *memory = mmap(nullptr, sizeof(SharedLoad) * num_workers, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
     {
-      perror("pipe");
+      perror("mmap");
       exit(1);
     }
+    worker_loads = static_cast<SharedLoad *>(memory);
+    worker_load_count = num_workers;
+  }
+
+  for (int i = 0; i < num_workers; ++i)
+  {
+    WorkerRing *ring = create_worker_ring();
 
     pid_t pid = fork();
     if (pid == -1)
@@ -135,46 +338,120 @@ void init_workers(int num_workers, const RoutingConfig &config)
     }
     else if (pid == 0)
     {
-      close(pipefd[1]); // child closes write
-      worker_loop(pipefd[0], i);
+      worker_loop(*ring, i, num_workers);
       exit(0);
     }
     else
     {
-      close(pipefd[0]); // parent closes read
-      workers.push_back({pipefd[1], pid});
+      workers.push_back({ring, pid, std::make_unique<std::mutex>()});
+      if (stats)
+        stats->add_queue("worker_" + std::to_string(i) + "_ring_bytes", [ring]
+                         { return static_cast<int64_t>(ring->head.load() - ring->tail.load()); });
     }
   }
 
-  std::cout << "Initialized " << workers.size() << " workers.\n";
+  LOG_INFO("Initialized " << workers.size() << " workers.");
 }
 
-void scatter_payload(const std::string &payload)
+int scatter_backlog()
 {
+  if (g_pool)
+    return static_cast<int>(g_pool->queued());
+
+  int backlog = 0;
+  for (int i = 0; worker_loads && i < worker_load_count; ++i)
+    backlog += std::max(0, worker_loads[i].outstanding.load(std::memory_order_relaxed));
+  return backlog;
+}
+
+bool scatter_payload(const DataRequest &request, const TraceContext *trace)
+{
+  TraceContext departed;
+  if (trace)
+  {
+    departed = *trace;
+    departed.depart();
+    trace = &departed;
+  }
+
+  if (g_pool)
+  {
+    submit_to_pool(request, trace);
+    return true;
+  }
   if (workers.empty())
-    return;
+    return false;
 
-  int target = current_worker % workers.size();
-  current_worker++;
+  thread_local std::string serialized;
+  serialized.clear();
+  std::string encoded = trace ? encode_trace(*trace) : std::string();
+  uint16_t trace_length = static_cast<uint16_t>(std::min<size_t>(encoded.size(), UINT16_MAX));
+  serialized.append(reinterpret_cast<const char *>(&trace_length), sizeof(trace_length));
+  serialized.append(encoded, 0, trace_length);
+  request.AppendToString(&serialized);
 
-  write(workers[target].write_fd, payload.c_str(), payload.size());
+  int index;
+  if (g_config.scatter.dispatch == ScatterDispatch::PowerOfTwo)
+  {
+    thread_local std::mt19937_64 rng(std::random_device{}());
+    index = select_p2c(worker_loads, static_cast<int>(workers.size()), rng());
+  }
+  else
+  {
+    index = static_cast<int>(current_worker.fetch_add(1, std::memory_order_relaxed) % workers.size());
+  }
+  if (worker_loads)
+    begin_requests(worker_loads[index], 1);
+  Worker &worker = workers[index];
+
+  // RPC handler threads dispatch concurrently; each ring has one producer.
+  std::lock_guard<std::mutex> lock(*worker.push_mutex);
+  if (!ring_push(*worker.ring, serialized.data(), static_cast<uint32_t>(serialized.size())))
+  {
+    LOG_ERROR("[Node B] ❌ Dropped record of " << serialized.size() << " bytes: worker ring unavailable");
+    if (worker_loads)
+      end_requests(worker_loads[index], 1, std::chrono::microseconds(0), false);
+    return false;
+  }
+  return true;
 }
 
 void shutdown_workers()
 {
-  std::cout << "\n[Node B] Shutting down workers..." << std::endl;
+  LOG_INFO("\n[Node B] Shutting down workers...");
+
+  if (g_pool)
+  {
+    g_pool.reset(); // finishes queued sends
+    if (g_retries)
+      g_retries->stop();
+    g_batcher.reset();
+    g_retries.reset();
+    g_credits.reset();
+    g_channels.reset();
+    LOG_INFO("  ✔ Worker pool drained.");
+    return;
+  }
 
   for (const auto &worker : workers)
   {
-    close(worker.write_fd);
+    ring_close(*worker.ring);
     kill(worker.pid, SIGTERM);
   }
 
   for (const auto &worker : workers)
   {
     waitpid(worker.pid, nullptr, 0);
-    std::cout << "  ✔ Worker " << worker.pid << " exited cleanly.\n";
+    destroy_worker_ring(worker.ring);
+    LOG_INFO("  ✔ Worker " << worker.pid << " exited cleanly.");
   }
 
   workers.clear();
+
+  if (worker_loads)
+  {
+    munmap(worker_loads, sizeof(SharedLoad) * worker_load_count);
+    worker_loads = nullptr;
+    worker_load_count = 0;
+  }
 }
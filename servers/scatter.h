@@ -1,7 +1,21 @@
 #pragma once
 #include <string>
 #include "config_loader.h"
+#include "data.pb.h"
+#include "node_stats.h"
+#include "seen_summary.h"
+#include "trace.h"
 
-void init_workers(int num_workers, const RoutingConfig &config);
-void scatter_payload(const std::string &payload);
+// Starts config.scatter.workers forked workers or pool threads. Forward
+// results and queue depths are reported to `stats`, and fingerprints that
+// come back from the neighbors to `summary` (may be null); both must outlive
+// the workers.
+void init_workers(const RoutingConfig &config, StatsRecorder *stats, SeenSummary *summary = nullptr);
+// `trace`, when set, is closed for B and carried on to the worker. Returns
+// false if no worker could take the record.
+bool scatter_payload(const dataservice::DataRequest &request, const TraceContext *trace = nullptr);
+
+// Records handed to workers and not yet processed by them (0 in processes
+// mode unless scatter dispatch "p2c" or backpressure keeps per-worker counts).
+int scatter_backlog();
 void shutdown_workers();
@@ -0,0 +1,227 @@
+#include "seen_summary.h"
+#include "region_lock.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+
+namespace
+{
+  // A worker that died holding the lock leaves at worst a short count; the
+  // queue is best-effort anyway.
+  class OutboxLock
+  {
+  public:
+    explicit OutboxLock(pthread_mutex_t &mutex) : mutex_(mutex)
+    {
+      if (pthread_mutex_lock(&mutex_) == EOWNERDEAD)
+        pthread_mutex_consistent(&mutex_);
+    }
+    ~OutboxLock() { pthread_mutex_unlock(&mutex_); }
+
+  private:
+    pthread_mutex_t &mutex_;
+  };
+
+  // Double hashing over the (already mixed) fingerprint.
+  uint64_t probe_step(uint64_t fingerprint)
+  {
+    return (fingerprint >> 32 | fingerprint << 32) | 1;
+  }
+
+  int64_t now_ns()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  // Most fingerprints one of `generations` filters of `bits` bits may hold
+  // with the window's false-positive rate still under `max_rate`: solves
+  // (1 - e^(-k n / m))^k = max_rate / generations for n.
+  uint64_t records_under(double max_rate, int generations, uint64_t bits, int hashes)
+  {
+    double k = hashes;
+    double fill = std::pow(max_rate / generations, 1 / k);
+    return std::max<uint64_t>(1, static_cast<uint64_t>(-(bits / k) * std::log1p(-fill)));
+  }
+}
+
+SeenSummary::SeenSummary(const SeenSummaryOptions &options, bool ingress) : options_(options)
+{
+  if (ingress)
+  {
+    options_.generations = std::max(1, options_.generations);
+    uint64_t bits = 64;
+    while (bits < static_cast<uint64_t>(options_.bloom_bits))
+      bits <<= 1;
+    bit_mask_ = bits - 1;
+    words_ = bits / 64;
+    generation_records_ = records_under(options_.max_false_positive, options_.generations, bits, options_.hashes);
+    if (options_.generation_records > 0)
+      generation_records_ = std::min<uint64_t>(generation_records_, options_.generation_records);
+    generation_ns_ = options_.generation_ms * 1000000LL;
+    bits_ = std::vector<std::atomic<uint64_t>>(words_ * (options_.generations + 1));
+    opened_ns_.store(now_ns(), std::memory_order_relaxed);
+    return;
+  }
+
+  outbox_bytes_ = sizeof(Outbox) + sizeof(uint64_t) * options_.queue_limit;
+  void *memory = mmap(nullptr, outbox_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED)
+  {
+    perror("mmap");
+    exit(1);
+  }
+  outbox_ = new (memory) Outbox(); // zero-filled by mmap
+  init_region_mutex(outbox_->mutex);
+}
+
+SeenSummary::~SeenSummary()
+{
+  if (outbox_)
+    munmap(outbox_, outbox_bytes_);
+}
+
+std::atomic<uint64_t> *SeenSummary::filter(uint64_t generation)
+{
+  return bits_.data() + generation % (options_.generations + 1) * words_;
+}
+
+const std::atomic<uint64_t> *SeenSummary::filter(uint64_t generation) const
+{
+  return bits_.data() + generation % (options_.generations + 1) * words_;
+}
+
+// Moves on to the spare and clears the filter that just left the window to
+// be the next spare. Under close_mu_, so the next close waits for that.
+void SeenSummary::close_generation(uint64_t generation)
+{
+  std::unique_lock<std::mutex> lock(close_mu_, std::try_to_lock);
+  if (!lock.owns_lock() || current_.load(std::memory_order_acquire) != generation)
+    return; // someone else is closing it, or did
+  inserted_.store(0, std::memory_order_relaxed);
+  opened_ns_.store(now_ns(), std::memory_order_relaxed);
+  current_.store(generation + 1, std::memory_order_release);
+
+  // generation + 1 - generations left the window; its filter is next's next.
+  std::atomic<uint64_t> *spare = filter(generation + 2);
+  for (uint64_t i = 0; i < words_; ++i)
+    spare[i].store(0, std::memory_order_relaxed);
+}
+
+void SeenSummary::add(uint64_t fingerprint)
+{
+  if (!bits_.empty())
+  {
+    uint64_t generation = current_.load(std::memory_order_acquire);
+    std::atomic<uint64_t> *bits = filter(generation);
+    uint64_t step = probe_step(fingerprint);
+    bool fresh = false;
+    for (int i = 0; i < options_.hashes; ++i)
+    {
+      uint64_t bit = (fingerprint + i * step) & bit_mask_;
+      uint64_t mask = 1ULL << (bit % 64);
+      if (!(bits[bit / 64].fetch_or(mask, std::memory_order_relaxed) & mask))
+        fresh = true;
+    }
+    // Repeats (every storing node reports the same record) set no new bit
+    // and do not count toward the generation.
+    uint64_t inserted = fresh ? inserted_.fetch_add(1, std::memory_order_relaxed) + 1
+                              : inserted_.load(std::memory_order_relaxed);
+    if (inserted >= generation_records_ ||
+        (generation_ns_ > 0 && now_ns() - opened_ns_.load(std::memory_order_relaxed) >= generation_ns_))
+      close_generation(generation);
+    return;
+  }
+
+  OutboxLock lock(outbox_->mutex);
+  if (outbox_->count < options_.queue_limit)
+    outbox_->fingerprints()[outbox_->count++] = fingerprint;
+}
+
+void SeenSummary::absorb(const grpc::ClientContext *context)
+{
+  if (!context)
+    return;
+  auto range = context->GetServerTrailingMetadata().equal_range(kSeenHeader);
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    const char *data = it->second.data();
+    for (size_t offset = 0; offset + sizeof(uint64_t) <= it->second.size(); offset += sizeof(uint64_t))
+    {
+      uint64_t fingerprint;
+      memcpy(&fingerprint, data + offset, sizeof(fingerprint));
+      add(fingerprint);
+    }
+  }
+}
+
+void SeenSummary::push(grpc::ServerContextBase &context)
+{
+  if (!outbox_)
+    return;
+  std::string packed;
+  {
+    OutboxLock lock(outbox_->mutex);
+    int64_t taken = std::min<int64_t>(outbox_->count, options_.max_push);
+    if (taken == 0)
+      return;
+    outbox_->count -= taken;
+    packed.assign(reinterpret_cast<const char *>(outbox_->fingerprints() + outbox_->count),
+                  taken * sizeof(uint64_t));
+  }
+  context.AddTrailingMetadata(kSeenHeader, packed);
+}
+
+bool SeenSummary::might_contain(uint64_t fingerprint) const
+{
+  if (bits_.empty())
+    return false;
+  uint64_t step = probe_step(fingerprint);
+  uint64_t current = current_.load(std::memory_order_acquire);
+  for (uint64_t back = 0; back < static_cast<uint64_t>(options_.generations) && back <= current; ++back)
+  {
+    const std::atomic<uint64_t> *bits = filter(current - back);
+    bool all = true;
+    for (int i = 0; all && i < options_.hashes; ++i)
+    {
+      uint64_t bit = (fingerprint + i * step) & bit_mask_;
+      all = bits[bit / 64].load(std::memory_order_relaxed) & (1ULL << (bit % 64));
+    }
+    if (all)
+      return true;
+  }
+  return false;
+}
+
+double SeenSummary::false_positive_rate() const
+{
+  if (bits_.empty())
+    return 0;
+  uint64_t current = current_.load(std::memory_order_acquire);
+  double none = 1;
+  for (uint64_t back = 0; back < static_cast<uint64_t>(options_.generations) && back <= current; ++back)
+  {
+    const std::atomic<uint64_t> *bits = filter(current - back);
+    uint64_t set = 0;
+    for (uint64_t i = 0; i < words_; ++i)
+      set += __builtin_popcountll(bits[i].load(std::memory_order_relaxed));
+    none *= 1 - std::pow(static_cast<double>(set) / (words_ * 64), options_.hashes);
+  }
+  return 1 - none;
+}
+
+int64_t SeenSummary::queued() const
+{
+  if (!outbox_)
+    return 0;
+  OutboxLock lock(outbox_->mutex);
+  return outbox_->count;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "config_loader.h"
+
+#include <grpcpp/grpcpp.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <pthread.h>
+#include <vector>
+
+// Tree-wide summary of the payload fingerprints storage nodes have accepted,
+// so node A can drop a repeat before it costs three hops. Each node with a
+// SeenSet queues the fingerprints it accepts; every response it sends
+// upstream carries up to max_push queued ones in the x-mini2-seen-bin
+// trailer, and every node relays what its children's responses carried the
+// same way. At the ingress they land in a Bloom filter.
+//
+// Like the SeenSets, the filter forgets: it is a ring of per-generation
+// filters over a window no longer than any SeenSet's. New fingerprints go
+// into the newest; once that holds generation_records (or max_false_positive
+// would be exceeded, or generation_ms have passed) the oldest is dropped and
+// cleared. The filter can only say "probably seen": a false positive drops a
+// new record at A, at a rate kept under max_false_positive. Everything that
+// gets through is still checked exactly against the owner's SeenSet.
+
+constexpr char kSeenHeader[] = "x-mini2-seen-bin";
+
+class SeenSummary
+{
+public:
+  // `ingress` keeps a Bloom filter; other nodes only relay. The relay queue
+  // lives in an anonymous shared mapping, so workers forked afterwards (node
+  // B's) feed the queue the parent drains.
+  SeenSummary(const SeenSummaryOptions &options, bool ingress);
+  ~SeenSummary();
+
+  SeenSummary(const SeenSummary &) = delete;
+  SeenSummary &operator=(const SeenSummary &) = delete;
+
+  // A fingerprint this node or its subtree accepted.
+  void add(uint64_t fingerprint);
+  // Takes the fingerprints a finished downstream call carried back (context
+  // may be null when the call never went out).
+  void absorb(const grpc::ClientContext *context);
+  // Moves up to max_push queued fingerprints into a response's trailers.
+  void push(grpc::ServerContextBase &context);
+
+  // Ingress only: false means definitely not seen.
+  bool might_contain(uint64_t fingerprint) const;
+  // Ingress only: the odds that might_contain() is wrong about a new
+  // fingerprint, estimated from the bits set across the window.
+  double false_positive_rate() const;
+
+  // Relay: fingerprints waiting for a response upstream. Once queue_limit
+  // are waiting, further ones are dropped; A just misses those repeats.
+  int64_t queued() const;
+
+private:
+  // Relay queue shared with forked workers. Order does not matter to the
+  // filter, so it is a stack.
+  struct Outbox
+  {
+    pthread_mutex_t mutex; // robust, process-shared
+    int64_t count;
+
+    // queue_limit fingerprints follow the header.
+    uint64_t *fingerprints() { return reinterpret_cast<uint64_t *>(this + 1); }
+  };
+
+  // Filter of `generation`, in the ring of generations + 1 (one spare).
+  std::atomic<uint64_t> *filter(uint64_t generation);
+  const std::atomic<uint64_t> *filter(uint64_t generation) const;
+  void close_generation(uint64_t generation);
+
+  SeenSummaryOptions options_;
+  // Ingress only.
+  uint64_t bit_mask_ = 0;
+  uint64_t words_ = 0;                     // per filter
+  uint64_t generation_records_ = 0;        // fingerprints that close a generation
+  int64_t generation_ns_ = 0;              // > 0: age that closes one
+  std::vector<std::atomic<uint64_t>> bits_; // the filters, back to back
+  std::atomic<uint64_t> current_{0};
+  std::atomic<uint64_t> inserted_{0};   // new fingerprints in current_
+  std::atomic<int64_t> opened_ns_{0};   // when current_ opened
+  std::mutex close_mu_;                 // one closer at a time
+
+  Outbox *outbox_ = nullptr; // relays only
+  size_t outbox_bytes_ = 0;
+};
@@ -1,54 +1,365 @@
 #include "data.grpc.pb.h"
 #include "config_loader.h"
+#include "logger.h"
+#include "channel_registry.h"
+#include "batcher.h"
+#include "collision_record.h"
+#include "node_stats.h"
+#include "trace.h"
+#include "credits.h"
+#include "fanout.h"
+#include "dedup.h"
+#include "seen_summary.h"
 #include <grpcpp/grpcpp.h>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 
+using dataservice::DataBatch;
 using dataservice::DataRequest;
 using dataservice::DataService;
 using dataservice::Empty;
+using dataservice::IngestSummary;
+using dataservice::NodeStats;
 using grpc::Server;
 using grpc::ServerBuilder;
 using grpc::ServerContext;
+using grpc::ServerReader;
 using grpc::Status;
 
 RoutingConfig config;
+std::unique_ptr<ChannelRegistry> channels;
+std::unique_ptr<BatchForwarder> batcher; // null unless batching is enabled
+std::unique_ptr<StatsRecorder> stats;
+std::unique_ptr<EdgeCredits> credits;      // null unless backpressure is enabled
+std::unique_ptr<Admission> admission;      // null unless backpressure is enabled
+std::unique_ptr<SeenSummary> seen_summary; // null unless seen_summary is enabled
+std::unique_ptr<OverloadRetries> retries;  // null unless batching and backpressure are enabled
+
+// Max records of one ingest stream that may be forwarded but not yet acked.
+constexpr int kStreamWindow = 64;
+
+// Flow control for StreamData: the next Read() waits while the window is
+// full, so a fast client is held back by HTTP/2 flow control instead of A
+// queueing records without bound.
+class ForwardWindow
+{
+public:
+  explicit ForwardWindow(int limit) : limit_(limit) {}
+
+  void acquire()
+  {
+    std::unique_lock<std::mutex> lock(mu_);
+    cv_.wait(lock, [this]
+             { return in_flight_ < limit_; });
+    in_flight_++;
+  }
+
+  void release(bool ok)
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    in_flight_--;
+    if (ok)
+      accepted_++;
+    else
+      rejected_++;
+    cv_.notify_all();
+  }
+
+  void reject()
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    rejected_++;
+  }
+
+  // A record that is done without a forward (a suppressed duplicate).
+  void accept()
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    accepted_++;
+  }
+
+  // Waits for all outstanding forwards, then fills the summary.
+  void drain(IngestSummary *summary)
+  {
+    std::unique_lock<std::mutex> lock(mu_);
+    cv_.wait(lock, [this]
+             { return in_flight_ == 0; });
+    summary->set_accepted(accepted_);
+    summary->set_rejected(rejected_);
+  }
+
+private:
+  std::mutex mu_;
+  std::condition_variable cv_;
+  int limit_;
+  int in_flight_ = 0;
+  uint64_t accepted_ = 0;
+  uint64_t rejected_ = 0;
+};
+
+// One streamed record fanned out to every neighbor; it counts as accepted
+// once all forwards have succeeded.
+struct StreamedRecord
+{
+  std::mutex mu;
+  int remaining = 0;
+  bool failed = false;
+  DataRequest request;
+  bool traced = false;
+  TraceContext trace;
+};
+
+struct StreamedForward
+{
+  grpc::ClientContext context;
+  Empty response;
+};
+
+// Tells the client how many more records A can take right now.
+Status respond(ServerContext *context, const Status &status)
+{
+  if (admission)
+    grant_credits(*context, admission->credits());
+  return status;
+}
+
+// Whether the seen summary says a storage node already accepted this record.
+// Such records are acked like a duplicate downstream would be, without
+// going any further.
+bool likely_duplicate(const DataRequest &request)
+{
+  if (!seen_summary || !seen_summary->might_contain(payload_fingerprint(payload_text(request))))
+    return false;
+  stats->duplicates();
+  LOG_SAMPLED(LogLevel::Info, "[Node " << config.node_name << "] ⚠️ Already stored downstream per the seen summary. Dropping.");
+  return true;
+}
+
+// A batched record is acked to the client before its batch goes out, so one
+// a neighbor turns away is kept and sent again rather than lost.
+BatchForwarder::RecordDone retry_on_overload(const std::string &neighbor, const DataRequest &record)
+{
+  if (!retries)
+    return nullptr;
+  return [neighbor, record](const Status &status)
+  { retries->retry(neighbor, record, status); };
+}
+
+// Forwards one client record to every neighbor. RESOURCE_EXHAUSTED when no
+// credits toward a neighbor free up in time, or a neighbor itself reports it.
+Status forward_record(const DataRequest *request)
+{
+  auto start = std::chrono::steady_clock::now();
+  int64_t arrived_us = trace_now_us();
+  LOG_SAMPLED(LogLevel::Info, "[Node " << config.node_name << "] Received: " << request->payload());
+  stats->received();
+  if (likely_duplicate(*request))
+    return Status::OK;
+
+  if (credits && !credits->acquire(config.neighbors, 1, credits->queue_timeout()))
+  {
+    LOG_SAMPLED(LogLevel::Warn, "[Node " << config.node_name << "] ⛔ Out of credits; rejecting record");
+    return overloaded(config.node_name);
+  }
+  stats->processed();
+  Status result = Status::OK;
+
+  TraceContext trace;
+  bool traced = start_trace(config.tracing, trace);
+  if (traced)
+    trace.arrive(config.node_name, arrived_us);
+
+  // Parse the CSV line once here; every later hop carries the typed record.
+  DataRequest forward_request = *request;
+  make_typed(forward_request);
+
+  // Forward to the next node(s) based on config
+  if (batcher)
+  {
+    for (const auto &neighbor : config.neighbors)
+      batcher->add(neighbor, forward_request, retry_on_overload(neighbor, forward_request),
+                   traced ? &trace : nullptr);
+  }
+  else
+  {
+    if (traced)
+      trace.depart();
+    auto results = fan_out(
+        *channels, config.neighbors, forward_request,
+        [&](grpc::ClientContext &ctx)
+        {
+          if (traced)
+            attach_traces(ctx, {{0, trace}});
+        },
+        [](const FanoutResult &forward, const grpc::ClientContext *ctx)
+        {
+          if (credits)
+            credits->release(forward.neighbor, 1, ctx);
+          if (seen_summary)
+            seen_summary->absorb(ctx);
+        });
+
+    for (const auto &forward : results)
+    {
+      if (!forward.sent)
+        continue;
+      stats->forwarded(forward.neighbor, 1, forward.status.ok());
+      if (forward.status.ok())
+      {
+        LOG_SAMPLED(LogLevel::Debug, "✅ Forwarded to " << forward.neighbor << " (" << channels->address(forward.neighbor) << ") in " << forward.latency.count() << " us");
+      }
+      else
+      {
+        LOG_ERROR("❌ Failed to forward to " << forward.neighbor << ": " << forward.status.error_message());
+        if (forward.status.error_code() == grpc::StatusCode::RESOURCE_EXHAUSTED)
+          result = forward.status;
+      }
+    }
+  }
+
+  stats->observe_latency(std::chrono::steady_clock::now() - start);
+  return result;
+}
 
 class ForwardingServiceImpl final : public DataService::Service
 {
 public:
   Status SendData(ServerContext *context, const DataRequest *request, Empty *response) override
   {
-    std::string data = request->payload();
-    std::cout << "[Node " << config.node_name << "] Received: " << data << std::endl;
+    Admitted admitted(admission.get(), 1);
+    if (!admitted.ok())
+      return respond(context, overloaded(config.node_name));
+    return respond(context, forward_record(request));
+  }
+
+  // Stops at the first rejected record; the ones before it were forwarded.
+  Status SendBatch(ServerContext *context, const DataBatch *batch, Empty *response) override
+  {
+    LOG_SAMPLED(LogLevel::Info, "[Node " << config.node_name << "] Received batch of " << batch->records_size());
+    Admitted admitted(admission.get(), batch->records_size());
+    if (!admitted.ok())
+      return respond(context, overloaded(config.node_name));
 
-    // Forward to the next node(s) based on config
-    if (config.routing_table.count(config.node_name))
+    for (const auto &record : batch->records())
     {
-      for (const auto &neighbor : config.routing_table[config.node_name])
+      Status status = forward_record(&record);
+      if (!status.ok())
+        return respond(context, status);
+    }
+    return respond(context, Status::OK);
+  }
+
+  Status StreamData(ServerContext *context, ServerReader<DataRequest> *reader, IngestSummary *summary) override
+  {
+    LOG_INFO("[Node " << config.node_name << "] 📥 Ingest stream opened by " << context->peer());
+
+    const std::vector<std::string> &neighbors = config.neighbors;
+    ForwardWindow window(kStreamWindow);
+    DataRequest request;
+
+    while (reader->Read(&request))
+    {
+      int64_t arrived_us = trace_now_us();
+      stats->received();
+      if (request.payload().empty() && !request.has_record())
+      {
+        window.reject();
+        continue;
+      }
+      if (likely_duplicate(request))
       {
-        std::string address = config.address_map[neighbor];
-        auto channel = grpc::CreateChannel(address, grpc::InsecureChannelCredentials());
-        std::unique_ptr<DataService::Stub> stub = DataService::NewStub(channel);
+        window.accept();
+        continue;
+      }
 
-        DataRequest forward_request;
-        forward_request.set_payload(data);
-        Empty forward_response;
-        grpc::ClientContext ctx;
+      std::vector<std::string> targets;
+      for (const auto &neighbor : neighbors)
+      {
+        if (!channels->address(neighbor).empty())
+          targets.push_back(neighbor);
+      }
+      if (targets.empty())
+      {
+        window.reject();
+        continue;
+      }
+
+      window.acquire();
+      if (credits && !credits->acquire(targets, 1, credits->queue_timeout()))
+      {
+        window.release(false);
+        continue;
+      }
+      stats->processed();
+
+      auto record = std::make_shared<StreamedRecord>();
+      record->remaining = static_cast<int>(targets.size());
+      record->request = request;
+      make_typed(record->request);
+      record->traced = start_trace(config.tracing, record->trace);
+      if (record->traced)
+        record->trace.arrive(config.node_name, arrived_us);
 
-        Status status = stub->SendData(&ctx, forward_request, &forward_response);
-        if (status.ok())
+      auto on_done = [record, &window](const Status &status)
+      {
+        bool done = false;
+        bool ok = false;
+        {
+          std::lock_guard<std::mutex> lock(record->mu);
+          if (!status.ok())
+          {
+            record->failed = true;
+            LOG_ERROR("❌ Stream forward failed: " << status.error_message());
+          }
+          done = --record->remaining == 0;
+          ok = !record->failed;
+        }
+        if (done)
+          window.release(ok);
+      };
+
+      for (const auto &neighbor : targets)
+      {
+        if (batcher)
         {
-          std::cout << "✅ Forwarded to " << neighbor << " (" << address << ")\n";
+          batcher->add(neighbor, record->request, on_done, record->traced ? &record->trace : nullptr);
+          continue;
         }
-        else
+
+        auto *call = new StreamedForward;
+        if (record->traced)
         {
-          std::cerr << "❌ Failed to forward to " << neighbor << ": " << status.error_message() << std::endl;
+          TraceContext trace = record->trace;
+          trace.depart();
+          attach_traces(call->context, {{0, trace}});
         }
+        channels->set_deadline(call->context, neighbor);
+        channels->stub(neighbor)->async()->SendData(&call->context, &record->request, &call->response,
+                                                    [call, on_done, neighbor](Status status)
+                                                    {
+                                                      if (credits)
+                                                        credits->release(neighbor, 1, &call->context);
+                                                      if (seen_summary)
+                                                        seen_summary->absorb(&call->context);
+                                                      delete call;
+                                                      stats->forwarded(neighbor, 1, status.ok());
+                                                      on_done(status);
+                                                    });
       }
     }
 
+    window.drain(summary);
+    LOG_INFO("[Node " << config.node_name << "] 📥 Ingest stream closed: " << summary->accepted() << " accepted, " << summary->rejected() << " rejected");
+    return Status::OK;
+  }
+
+  Status GetStats(ServerContext *context, const Empty *request, NodeStats *response) override
+  {
+    stats->fill(response);
     return Status::OK;
   }
 };
@@ -62,7 +373,7 @@ void RunServer()
   builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
   builder.RegisterService(&service);
   std::unique_ptr<Server> server(builder.BuildAndStart());
-  std::cout << "[Node " << config.node_name << "] Listening on " << server_address << std::endl;
+  LOG_INFO("[Node " << config.node_name << "] Listening on " << server_address);
   server->Wait();
 }
 
@@ -70,7 +381,7 @@ int main(int argc, char **argv)
 {
   if (argc < 2)
   {
-    std::cerr << "Usage: " << argv[0] << " <node_name>" << std::endl;
+    LOG_ERROR("Usage: " << argv[0] << " <node_name>");
     return 1;
   }
 
@@ -78,10 +389,50 @@ int main(int argc, char **argv)
   try
   {
     config = load_config("routing.json", node_name);
+    configure_logging(config.logging);
+    stats = std::make_unique<StatsRecorder>(config);
+    channels = std::make_unique<ChannelRegistry>(config);
+    if (config.backpressure.enabled)
+    {
+      credits = std::make_unique<EdgeCredits>(config.neighbors, config.backpressure);
+      admission = std::make_unique<Admission>(config.backpressure);
+      stats->add_queue("admitted_records", []
+                       { return admission->held(); });
+      stats->add_queue("credits_in_flight", []
+                       { return credits->in_flight(); });
+      stats->add_queue("credit_waiters", []
+                       { return credits->waiting(); });
+    }
+    if (config.seen_summary.enabled)
+    {
+      seen_summary = std::make_unique<SeenSummary>(config.seen_summary, true);
+      stats->add_queue("seen_summary_fp_ppm", []
+                       { return static_cast<int64_t>(seen_summary->false_positive_rate() * 1e6); });
+    }
+    if (config.batching.enabled)
+    {
+      batcher = std::make_unique<BatchForwarder>(*channels, config.neighbors, config.batching,
+                                                 [](const std::string &neighbor, int records, const Status &status,
+                                                    std::chrono::microseconds)
+                                                 { stats->forwarded(neighbor, records, status.ok()); },
+                                                 credits.get(), seen_summary.get());
+      stats->add_queue("batch_buffered_records", []
+                       { return batcher->buffered(); });
+      stats->add_queue("batches_in_flight", []
+                       { return batcher->in_flight(); });
+      if (credits)
+      {
+        retries = std::make_unique<OverloadRetries>(
+            *credits, [](const std::string &neighbor, const DataRequest &record)
+            { batcher->add(neighbor, record, retry_on_overload(neighbor, record)); });
+        stats->add_queue("overload_retry_records", []
+                         { return retries->queued(); });
+      }
+    }
   }
   catch (const std::exception &ex)
   {
-    std::cerr << "Failed to load config: " << ex.what() << std::endl;
+    LOG_ERROR("Failed to load config: " << ex.what());
     return 1;
   }
 
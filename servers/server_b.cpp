@@ -5,78 +5,109 @@
 #include "data.grpc.pb.h"
 #include "scatter.h"
 #include "config_loader.h"
+#include "collision_record.h"
+#include "logger.h"
+#include "node_stats.h"
+#include "trace.h"
+#include "credits.h"
+#include "seen_summary.h"
 #include "shared_data.h" // <-- Add this
+#include "shm_segment.h"
 #include <csignal>
-#include <semaphore.h> // <-- Add this
+#include <chrono>
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/mman.h>
 
 // These are needed to share the mutex and memory globally
-SharedData *shared_data = nullptr;
-sem_t *shared_mutex = nullptr;
+ShmHeader *shared_segment = nullptr;
+SharedData *shared_data = nullptr; // B's region of shared_segment
 
 using grpc::Server;
 using grpc::ServerBuilder;
 using grpc::ServerContext;
 using grpc::Status;
 
+using dataservice::DataBatch;
 using dataservice::DataRequest;
 using dataservice::DataService;
 using dataservice::Empty;
+using dataservice::NodeStats;
 
 RoutingConfig config;
+std::unique_ptr<StatsRecorder> stats;
+std::unique_ptr<SeenSummary> seen_summary; // null unless seen_summary is enabled
 
 void setup_shared_memory()
 {
-  // Only Node B creates it
-  shm_unlink(SHM_NAME);
-  sem_unlink(SEM_NAME);
-
-  int fd = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0666);
-  if (fd == -1)
-  {
-    perror("shm_open");
-    exit(1);
-  }
-
-  size_t page_size = sysconf(_SC_PAGESIZE);
-  size_t data_size = sizeof(SharedData);
-  size_t aligned_size = ((data_size + page_size - 1) / page_size) * page_size;
+  shared_segment = attach_segment(config);
+  shared_data = region_data(*shared_segment, find_region(*shared_segment, config.node_name));
+}
 
-  std::cout << "[Node B] SharedData size: " << data_size << ", aligned to: " << aligned_size << std::endl;
+// Whether `records` more would push the workers' backlog past the budget.
+bool overloaded_by(int records)
+{
+  if (!config.backpressure.enabled)
+    return false;
+  int backlog = scatter_backlog();
+  return backlog > 0 && over_budget(config.backpressure, backlog, records);
+}
 
-  if (ftruncate(fd, aligned_size) == -1)
-  {
-    perror("ftruncate");
-    exit(1);
-  }
+// Grants upstream the records the workers can still take, and relays the
+// fingerprints the workers got back from C and D.
+Status respond(ServerContext *context, const Status &status)
+{
+  if (config.backpressure.enabled)
+    grant_credits(*context, credits_for(config.backpressure, scatter_backlog()));
+  if (seen_summary)
+    seen_summary->push(*context);
+  return status;
+}
 
-  void *ptr = mmap(nullptr, aligned_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-  if (ptr == MAP_FAILED)
+class DataServiceImpl final : public DataService::Service
+{
+public:
+  Status SendData(ServerContext *context, const DataRequest *request, Empty *response) override
   {
-    perror("mmap");
-    exit(1);
+    auto start = std::chrono::steady_clock::now();
+    int64_t arrived_us = trace_now_us();
+    LOG_SAMPLED(LogLevel::Info, "[Node B] Received payload: " << payload_text(*request));
+    stats->received();
+    if (overloaded_by(1))
+      return respond(context, overloaded("B"));
+    stats->processed();
+    TraceSet traces = incoming_traces(*context);
+    TraceContext *trace = find_trace(traces, 0);
+    if (trace)
+      trace->arrive("B", arrived_us);
+    scatter_payload(*request, trace);
+    stats->observe_latency(std::chrono::steady_clock::now() - start);
+    return respond(context, Status::OK);
   }
 
-  shared_data = reinterpret_cast<SharedData *>(ptr);
-  shared_data->num_neighbors = 0;
-
-  shared_mutex = sem_open(SEM_NAME, O_CREAT, 0666, 1);
-  if (shared_mutex == SEM_FAILED)
+  Status SendBatch(ServerContext *context, const DataBatch *batch, Empty *response) override
   {
-    perror("sem_open");
-    exit(1);
+    auto start = std::chrono::steady_clock::now();
+    int64_t arrived_us = trace_now_us();
+    LOG_SAMPLED(LogLevel::Info, "[Node B] Received batch of " << batch->records_size());
+    stats->received(batch->records_size());
+    if (overloaded_by(batch->records_size()))
+      return respond(context, overloaded("B"));
+    stats->processed(batch->records_size());
+    TraceSet traces = incoming_traces(*context);
+    for (auto &entry : traces)
+      entry.second.arrive("B", arrived_us);
+    for (int i = 0; i < batch->records_size(); ++i)
+    {
+      scatter_payload(batch->records(i), find_trace(traces, i));
+    }
+    stats->observe_latency(std::chrono::steady_clock::now() - start);
+    return respond(context, Status::OK);
   }
-}
 
-class DataServiceImpl final : public DataService::Service
-{
-public:
-  Status SendData(ServerContext *context, const DataRequest *request, Empty *response) override
+  Status GetStats(ServerContext *context, const Empty *request, NodeStats *response) override
   {
-    std::cout << "[Node B] Received payload: " << request->payload() << std::endl;
-    scatter_payload(request->payload());
+    stats->fill(response);
     return Status::OK;
   }
 };
@@ -86,21 +117,23 @@ void RunServer()
   std::string address("0.0.0.0:50052");
   DataServiceImpl service;
 
-  init_workers(3, config);
+  init_workers(config, stats.get(), seen_summary.get());
 
   ServerBuilder builder;
   builder.AddListeningPort(address, grpc::InsecureServerCredentials());
   builder.RegisterService(&service);
 
   std::unique_ptr<Server> server(builder.BuildAndStart());
-  std::cout << "[Node B] Server listening on " << address << std::endl;
+  LOG_INFO("[Node B] Server listening on " << address);
   server->Wait();
 }
 
 void handle_sigint(int)
 {
   shutdown_workers();
-  std::cout << "[Node B] Exiting.\n";
+  if (shared_segment)
+    detach_segment(shared_segment, config.node_name);
+  LOG_INFO("[Node B] Exiting.");
   exit(0);
 }
 
@@ -108,7 +141,7 @@ int main(int argc, char **argv)
 {
   if (argc < 2)
   {
-    std::cerr << "Usage: " << argv[0] << " <node_name>" << std::endl;
+    LOG_ERROR("Usage: " << argv[0] << " <node_name>");
     return 1;
   }
 
@@ -116,12 +149,21 @@ int main(int argc, char **argv)
   try
   {
     config = load_config("routing.json", node_name);
-    std::cout << "[Node B] 🛠 Config loaded successfully.\n";
+    configure_logging(config.logging);
+    stats = std::make_unique<StatsRecorder>(config);
+    LOG_INFO("[Node B] 🛠 Config loaded successfully.");
     setup_shared_memory(); // ✅ ADD THIS
+    if (config.seen_summary.enabled)
+    {
+      // Before the workers fork, so they share its queue.
+      seen_summary = std::make_unique<SeenSummary>(config.seen_summary, false);
+      stats->add_queue("seen_summary_queued", []
+                       { return seen_summary->queued(); });
+    }
   }
   catch (const std::exception &ex)
   {
-    std::cerr << "Failed to load config: " << ex.what() << std::endl;
+    LOG_ERROR("Failed to load config: " << ex.what());
     return 1;
   }
 
@@ -1,7 +1,19 @@
 #include "data.grpc.pb.h"
 #include "config_loader.h"
+#include "channel_registry.h"
+#include "batcher.h"
+#include "collision_record.h"
 #include "shared_data.h"
-#include <semaphore.h>
+#include "shm_segment.h"
+#include "dedup.h"
+#include "hash_ring.h"
+#include "load_table.h"
+#include "appender.h"
+#include "node_stats.h"
+#include "logger.h"
+#include "trace.h"
+#include "credits.h"
+#include "seen_summary.h"
 
 #include <grpcpp/grpcpp.h>
 #include <iostream>
@@ -12,45 +24,81 @@
 #include <unistd.h>
 #include <sys/mman.h>
 #include <fstream>
-#include <climits>
+#include <algorithm>
 #include <chrono>
 #include <csignal>
-
+#include <atomic>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <random>
+#include <vector>
+
+using dataservice::DataBatch;
 using dataservice::DataRequest;
 using dataservice::DataService;
 using dataservice::Empty;
+using dataservice::NodeStats;
 using grpc::Server;
 using grpc::ServerBuilder;
 using grpc::ServerContext;
 using grpc::Status;
 
 RoutingConfig config;
-SharedData *shared_data = nullptr;
-sem_t *shared_mutex = nullptr;
+std::unique_ptr<ChannelRegistry> channels;
+std::unique_ptr<BatchForwarder> batcher;   // null unless batching is enabled
+std::unique_ptr<EdgeCredits> credits;      // null unless backpressure is enabled
+std::unique_ptr<Admission> admission;      // null unless backpressure is enabled
+std::unique_ptr<SeenSummary> seen_summary; // null unless seen_summary is enabled
+std::unique_ptr<OverloadRetries> retries;  // null unless backpressure is enabled
+ShmHeader *shared_segment = nullptr;
+SharedData *shared_data = nullptr; // this node's region of shared_segment
+SeenSet *seen_set = nullptr; // null if the region has none
 
 enum class LoadStrategy
 {
   RoundRobin,
-  LeastLoaded
+  LeastLoaded,
+  PowerOfTwo,    // p2c over latency EWMA x outstanding records
+  ConsistentHash // each record goes to its placement owner
 };
 LoadStrategy strategy = LoadStrategy::LeastLoaded;
-int rr_index = 0;
+std::atomic<unsigned> rr_index{0};
+
+// ConsistentHash only: the ring and, per owner, the neighbor leading to it.
+std::unique_ptr<HashRing> ring;
+std::unordered_map<std::string, std::string> routes_to_owner;
+
+enum class ServerMode
+{
+  Sync,
+  Async
+};
+ServerMode server_mode = ServerMode::Sync;
 
 // Benchmarking
 std::chrono::steady_clock::time_point server_start_time;
-int processed_count = 0;
-int duplicate_count = 0;
-int forwarded_count = 0;
+std::unique_ptr<StatsRecorder> stats;
+
+// node_<X>_data.txt and duplicates.txt, kept open for the process lifetime.
+std::unique_ptr<Appender> data_log;
+std::unique_ptr<Appender> duplicate_log;
+std::unique_ptr<Appender> trace_log; // leaves with tracing enabled only
 
 void write_benchmark_and_exit(int signum)
 {
   auto end_time = std::chrono::steady_clock::now();
   auto duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - server_start_time).count();
 
+  data_log.reset();
+  duplicate_log.reset();
+  trace_log.reset();
+
+  uint64_t processed_count = stats->processed_count();
   std::ofstream bench("benchmark_" + config.node_name + ".txt", std::ios::out);
   bench << "Messages Processed: " << processed_count << "\n";
-  bench << "Duplicates Skipped: " << duplicate_count << "\n";
-  bench << "Messages Forwarded: " << forwarded_count << "\n";
+  bench << "Duplicates Skipped: " << stats->duplicate_count() << "\n";
+  bench << "Messages Forwarded: " << stats->forwarded_count() << "\n";
   bench << "Total Time (ms): " << duration_ms << "\n";
   if (duration_ms > 0)
   {
@@ -58,129 +106,487 @@ void write_benchmark_and_exit(int signum)
   }
   bench.flush();
   bench.close();
-  std::cout << "\n📈 Benchmark written to benchmark_" << config.node_name << ".txt. Exiting...\n";
+  LOG_INFO("\n📈 Benchmark written to benchmark_" << config.node_name << ".txt. Exiting...");
+  if (shared_segment)
+    detach_segment(shared_segment, config.node_name);
   exit(signum);
 }
 
 void setup_shared_memory()
 {
-  shm_unlink(SHM_NAME);
-  sem_unlink(SEM_NAME);
+  shared_segment = attach_segment(config);
+  shared_data = region_data(*shared_segment, find_region(*shared_segment, config.node_name));
+  seen_set = shared_data->seen_set();
+
+  // Register the neighbors in config order; a restarted node finds them there.
+  for (const auto &neighbor : config.neighbors)
+    add_load(*shared_data, neighbor, 0);
+}
+
+// Lock-free check-and-mark against this node's seen set. Returns false for
+// a duplicate. Accepted fingerprints are queued for node A's summary.
+bool mark_if_new(const std::string &payload)
+{
+  if (!seen_set)
+    return true;
+  if (!mark_processed(*seen_set, payload))
+    return false;
+  if (seen_summary)
+    seen_summary->add(payload_fingerprint(payload));
+  return true;
+}
+
+// Picks the next hop from the shared load table without locking. `pending`
+// counts records already assigned to each load slot but not yet acked, so a
+// batch spreads across neighbors instead of piling onto the current minimum.
+std::string select_next_hop(const int *pending = nullptr)
+{
+  if (strategy == LoadStrategy::RoundRobin)
+  {
+    int slot = select_round_robin(*shared_data, rr_index);
+    if (slot < 0)
+      return "";
+    LOG_SAMPLED(LogLevel::Debug, "[Node " << config.node_name << "] 🔄 Round Robin → " << shared_data->loads[slot].name);
+    return shared_data->loads[slot].name;
+  }
+
+  if (strategy == LoadStrategy::PowerOfTwo)
+  {
+    // Outstanding goes up as soon as a record is assigned, which also spreads
+    // a batch without the pending counts.
+    thread_local std::mt19937_64 rng(std::random_device{}());
+    int slot = select_p2c(*shared_data, rng());
+    if (slot < 0)
+      return "";
+    begin_requests(*shared_data, slot, 1);
+    LOG_SAMPLED(LogLevel::Debug, "[Node " << config.node_name << "] 🎲 P2C → " << shared_data->loads[slot].name);
+    return shared_data->loads[slot].name;
+  }
+
+  int slot = select_least_loaded(*shared_data, pending);
+  if (slot < 0)
+    return "";
+  LOG_SAMPLED(LogLevel::Debug, "[Node " << config.node_name << "] ⚖️ Least Loaded → " << shared_data->loads[slot].name);
+  return shared_data->loads[slot].name;
+}
+
+bool is_leaf()
+{
+  return config.neighbors.empty();
+}
+
+// Whether records this node accepts end here. Under ConsistentHash a record
+// is only accepted by its owner, wherever that sits in the tree.
+bool stores_final_copy()
+{
+  return is_leaf() || strategy == LoadStrategy::ConsistentHash;
+}
 
-  int fd = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0666);
-  if (fd == -1)
+// ConsistentHash: the neighbor toward the payload's owner, or "" when this
+// node owns it (or the owner is unreachable, so it is kept here instead).
+std::string route_to_owner(const std::string &payload)
+{
+  const std::string &owner = ring->owner(payload);
+  auto it = routes_to_owner.find(owner);
+  if (it == routes_to_owner.end())
   {
-    perror("shm_open");
-    exit(1);
+    if (owner != config.node_name)
+      LOG_SAMPLED(LogLevel::Warn, "[Node " << config.node_name << "] ⚠️ No route to owner " << owner << "; storing locally.");
+    return "";
   }
+  LOG_SAMPLED(LogLevel::Debug, "[Node " << config.node_name << "] 🎯 Owner " << owner << " → " << it->second);
+  return it->second;
+}
 
-  size_t page_size = sysconf(_SC_PAGESIZE);
-  size_t data_size = sizeof(SharedData);
-  size_t aligned_size = ((data_size + page_size - 1) / page_size) * page_size;
+// Closes the leaf hop of a stored record and writes the finished trace out.
+void complete_trace(TraceContext *trace)
+{
+  if (!trace || !trace_log)
+    return;
+  trace->depart();
+  trace_log->append(trace_json(*trace) + "\n");
+}
 
-  std::cout << "SharedData size: " << data_size << ", aligned to: " << aligned_size << std::endl;
+// Opens this node's hop on every trace carried by an inbound RPC.
+TraceSet arrive_traces(const grpc::ServerContextBase &context, int64_t arrived_us)
+{
+  TraceSet traces = incoming_traces(context);
+  for (auto &entry : traces)
+    entry.second.arrive(config.node_name, arrived_us);
+  return traces;
+}
 
-  if (ftruncate(fd, aligned_size) == -1)
+// Book-keeping once `records` forwarded to neighbor have completed.
+void record_forward(const std::string &neighbor, int records, const grpc::Status &status,
+                    std::chrono::microseconds latency)
+{
+  stats->forwarded(neighbor, records, status.ok());
+  if (strategy == LoadStrategy::PowerOfTwo)
   {
-    perror("ftruncate");
-    exit(1);
+    int slot = find_load_slot(*shared_data, neighbor);
+    if (slot >= 0)
+      end_requests(*shared_data, slot, records, latency, status.ok());
   }
+  if (status.ok())
+  {
+    LOG_SAMPLED(LogLevel::Debug, "  → Forwarded " << records << " to " << neighbor << " (" << channels->address(neighbor) << ")");
 
-  void *ptr = mmap(nullptr, aligned_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-  if (ptr == MAP_FAILED)
+    add_load(*shared_data, neighbor, records);
+  }
+  else
   {
-    perror("mmap");
-    exit(1);
+    LOG_ERROR("  ✖ Failed to forward to " << neighbor << ": " << status.error_message());
   }
+}
 
-  shared_data = reinterpret_cast<SharedData *>(ptr);
-  memset(shared_data, 0, sizeof(SharedData));
+// Closes this node's hop on `trace` and sends it along with the next call.
+void attach_departing(grpc::ClientContext &context, TraceContext *trace)
+{
+  if (!trace)
+    return;
+  trace->depart();
+  attach_traces(context, {{0, *trace}});
+}
 
-  shared_data->num_neighbors = static_cast<int>(config.neighbors.size());
-  for (int i = 0; i < shared_data->num_neighbors; ++i)
+// Outbound call state; must outlive the async SendData.
+struct ForwardCall
+{
+  grpc::ClientContext context;
+  DataRequest request;
+  Empty response;
+  std::chrono::steady_clock::time_point sent;
+};
+
+std::chrono::microseconds elapsed_since(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+
+Status no_channel(const std::string &neighbor)
+{
+  return Status(grpc::StatusCode::UNAVAILABLE, "no channel to " + neighbor);
+}
+
+// This node has stored and acked a forwarded record before the next hop
+// answers, so one the next hop turns away is retried rather than lost.
+// Batched records are kept until their batch is acked for that.
+BatchForwarder::RecordDone retry_on_overload(const std::string &next_hop, const DataRequest &record)
+{
+  if (!retries)
+    return nullptr;
+  return [next_hop, record](const grpc::Status &status)
+  { retries->retry(next_hop, record, status); };
+}
+
+// Forwards one record without blocking: through the batcher when batching
+// is enabled, otherwise as its own async SendData. `done` runs once the
+// record has been acked (or has failed) downstream.
+void forward_async(const std::string &next_hop, const DataRequest &record, std::function<void()> done,
+                   TraceContext *trace = nullptr)
+{
+  if (batcher)
   {
-    strncpy(shared_data->loads[i].name, config.neighbors[i].c_str(), MAX_NAME_LEN - 1);
-    shared_data->loads[i].name[MAX_NAME_LEN - 1] = '\0';
-    shared_data->loads[i].load_count = 0;
+    batcher->add(
+        next_hop, record, [done, retry = retry_on_overload(next_hop, record)](const grpc::Status &status)
+        {
+          if (retry)
+            retry(status);
+          done(); },
+        trace);
+    return;
   }
 
-  shared_mutex = sem_open(SEM_NAME, O_CREAT, 0666, 1);
-  if (shared_mutex == SEM_FAILED)
+  DataService::Stub *stub = channels->stub(next_hop);
+  if (!stub)
   {
-    perror("sem_open");
-    exit(1);
+    if (credits)
+      credits->release(next_hop, 1, nullptr);
+    record_forward(next_hop, 1, no_channel(next_hop), std::chrono::microseconds(0));
+    done();
+    return;
   }
+
+  auto *call = new ForwardCall;
+  call->request = record;
+  attach_departing(call->context, trace);
+  channels->set_deadline(call->context, next_hop);
+  call->sent = std::chrono::steady_clock::now();
+  stub->async()->SendData(&call->context, &call->request, &call->response,
+                          [call, next_hop, done](grpc::Status status)
+                          {
+                            if (credits)
+                              credits->release(next_hop, 1, &call->context);
+                            if (seen_summary)
+                              seen_summary->absorb(&call->context);
+                            record_forward(next_hop, 1, status, elapsed_since(call->sent));
+                            if (retries)
+                              retries->retry(next_hop, call->request, status);
+                            delete call;
+                            done();
+                          });
 }
 
-bool is_duplicate(const std::string &node, const std::string &payload)
+// Blocking counterpart used by the sync service. With batching enabled the
+// record is only queued; the batch is acked asynchronously.
+void forward_sync(const std::string &next_hop, const DataRequest &record, TraceContext *trace = nullptr)
 {
-  char(*list)[MAX_PAYLOAD_LEN] = nullptr;
-  int count = 0;
-
-  if (node == "C")
+  if (batcher)
   {
-    list = shared_data->seen_payloads_c;
-    count = shared_data->count_c;
+    batcher->add(next_hop, record, retry_on_overload(next_hop, record), trace);
+    return;
   }
-  else if (node == "D")
+
+  DataService::Stub *stub = channels->stub(next_hop);
+  if (!stub)
   {
-    list = shared_data->seen_payloads_d;
-    count = shared_data->count_d;
+    if (credits)
+      credits->release(next_hop, 1, nullptr);
+    record_forward(next_hop, 1, no_channel(next_hop), std::chrono::microseconds(0));
+    return;
   }
-  else if (node == "E")
+
+  Empty forward_response;
+  grpc::ClientContext ctx;
+  attach_departing(ctx, trace);
+  channels->set_deadline(ctx, next_hop);
+  auto sent = std::chrono::steady_clock::now();
+  Status status = stub->SendData(&ctx, record, &forward_response);
+  if (credits)
+    credits->release(next_hop, 1, &ctx);
+  if (seen_summary)
+    seen_summary->absorb(&ctx);
+  record_forward(next_hop, 1, status, elapsed_since(sent));
+  if (retries)
+    retries->retry(next_hop, record, status);
+}
+
+// Takes credits for every forward of a call, all or nothing. When there are
+// none, each forward is booked as failed and the call is rejected.
+bool take_credits(const std::vector<std::pair<int, std::string>> &forwards, std::chrono::milliseconds max_wait)
+{
+  if (!credits)
+    return true;
+
+  std::map<std::string, int> per_neighbor;
+  for (const auto &[index, next_hop] : forwards)
+    per_neighbor[next_hop]++;
+  if (credits->acquire(per_neighbor, max_wait))
+    return true;
+
+  LOG_SAMPLED(LogLevel::Warn, "[Node " << config.node_name << "] ⛔ Out of credits; rejecting " << forwards.size() << " record(s)");
+  for (const auto &[neighbor, records] : per_neighbor)
+    record_forward(neighbor, records, overloaded(neighbor), std::chrono::microseconds(0));
+  return false;
+}
+
+// What became of one inbound record.
+enum class Acceptance
+{
+  Duplicate,
+  Stored,    // kept here; nothing to forward
+  Forward,   // to next_hop, whose credit is already held
+  Overloaded // no credit toward the next hop; nothing was recorded
+};
+
+void record_duplicate(const std::string &payload)
+{
+  stats->duplicates();
+  LOG_SAMPLED(LogLevel::Info, "[Node " << config.node_name << "] ⚠️ Duplicate payload. Skipping.");
+  duplicate_log->append("[Node " + config.node_name + "] Duplicate: " + payload + "\n");
+}
+
+// Hands back the credit and P2C assignment reserved for `records` toward
+// next_hop that turned out to be duplicates.
+void release_reservation(const std::string &next_hop, int records)
+{
+  if (credits)
+    credits->release(next_hop, records, nullptr);
+  if (strategy == LoadStrategy::PowerOfTwo)
   {
-    list = shared_data->seen_payloads_e;
-    count = shared_data->count_e;
+    int slot = find_load_slot(*shared_data, next_hop);
+    if (slot >= 0)
+      cancel_requests(*shared_data, slot, records);
   }
-  else if (node == "F")
+}
+
+// Dedup, store, and pick the next hop for one payload. The credit toward the
+// next hop is taken before the record is marked seen, so a record rejected
+// as Overloaded leaves no trace and its retry is not dropped as a duplicate.
+Acceptance accept_payload(const std::string &payload, std::string &next_hop, std::chrono::milliseconds max_wait,
+                          TraceContext *trace = nullptr)
+{
+  LOG_SAMPLED(LogLevel::Info, "[Node " << config.node_name << "] ✅ Received payload: " << payload);
+  stats->received();
+
+  // Not the owner: pass it on untouched and leave dedup to the owner.
+  if (strategy == LoadStrategy::ConsistentHash)
   {
-    list = shared_data->seen_payloads_f;
-    count = shared_data->count_f;
+    next_hop = route_to_owner(payload);
+    if (!next_hop.empty())
+    {
+      if (!take_credits({{0, next_hop}}, max_wait))
+        return Acceptance::Overloaded;
+      stats->processed();
+      return Acceptance::Forward;
+    }
   }
 
-  for (int i = 0; i < count; ++i)
+  if (!stores_final_copy())
   {
-    if (strncmp(list[i], payload.c_str(), MAX_PAYLOAD_LEN) == 0)
+    // A plain repeat need not wait for a credit it will not use.
+    if (seen_set && is_duplicate(*seen_set, payload))
     {
-      return true;
+      record_duplicate(payload);
+      return Acceptance::Duplicate;
     }
+    next_hop = select_next_hop();
+    if (!next_hop.empty() && !take_credits({{0, next_hop}}, max_wait))
+      return Acceptance::Overloaded;
   }
 
-  return false;
+  if (!mark_if_new(payload))
+  {
+    // Another copy got marked since the check above.
+    if (!next_hop.empty())
+      release_reservation(next_hop, 1);
+    next_hop.clear();
+    record_duplicate(payload);
+    return Acceptance::Duplicate;
+  }
+
+  stats->processed();
+
+  data_log->append(payload + "\n");
+
+  if (stores_final_copy())
+  {
+    complete_trace(trace);
+    return Acceptance::Stored;
+  }
+  return next_hop.empty() ? Acceptance::Stored : Acceptance::Forward;
 }
 
-void mark_processed(const std::string &node, const std::string &payload)
+// Batch counterpart of accept_payload: dedup and next-hop selection run
+// lock-free over the whole batch, and each output file is opened once.
+// Credits for every forward are taken, all or nothing, before any record is
+// marked seen; returns false, with nothing recorded, when they could not be.
+// Otherwise `forwards` gets (record index, next hop) for records that must
+// be forwarded.
+bool accept_batch(const DataBatch &batch, TraceSet &traces, std::chrono::milliseconds max_wait,
+                  std::vector<std::pair<int, std::string>> &forwards)
 {
-  char(*list)[MAX_PAYLOAD_LEN] = nullptr;
-  int *count = nullptr;
+  LOG_SAMPLED(LogLevel::Info, "[Node " << config.node_name << "] ✅ Received batch of " << batch.records_size());
+  stats->received(batch.records_size());
+
+  std::vector<int> candidates;
+  std::vector<int> accepted;
+  int passed = 0;
+  std::vector<int> duplicates;
+  int pending[MAX_NEIGHBORS] = {0};
+
+  std::vector<std::string> texts;
+  texts.reserve(batch.records_size());
+  for (const auto &record : batch.records())
+    texts.push_back(payload_text(record));
 
-  if (node == "C")
+  for (int i = 0; i < batch.records_size(); ++i)
   {
-    list = shared_data->seen_payloads_c;
-    count = &shared_data->count_c;
+    if (strategy == LoadStrategy::ConsistentHash)
+    {
+      std::string next_hop = route_to_owner(texts[i]);
+      if (!next_hop.empty())
+      {
+        forwards.emplace_back(i, next_hop);
+        passed++;
+        continue;
+      }
+    }
+
+    if (!stores_final_copy() && seen_set && is_duplicate(*seen_set, texts[i]))
+      duplicates.push_back(i);
+    else
+      candidates.push_back(i);
   }
-  else if (node == "D")
+
+  std::vector<std::string> hops(batch.records_size());
+  std::vector<std::pair<int, std::string>> reserved = forwards;
+  if (!stores_final_copy())
   {
-    list = shared_data->seen_payloads_d;
-    count = &shared_data->count_d;
+    for (int i : candidates)
+    {
+      hops[i] = select_next_hop(pending);
+      int slot = find_load_slot(*shared_data, hops[i]);
+      if (slot >= 0)
+        pending[slot]++;
+      if (!hops[i].empty())
+        reserved.emplace_back(i, hops[i]);
+    }
   }
-  else if (node == "E")
+  if (!take_credits(reserved, max_wait))
+  {
+    forwards.clear();
+    return false;
+  }
+
+  for (int i : candidates)
   {
-    list = shared_data->seen_payloads_e;
-    count = &shared_data->count_e;
+    if (mark_if_new(texts[i]))
+    {
+      accepted.push_back(i);
+      if (!hops[i].empty())
+        forwards.emplace_back(i, hops[i]);
+    }
+    else
+    {
+      duplicates.push_back(i);
+      if (!hops[i].empty())
+        release_reservation(hops[i], 1);
+    }
   }
-  else if (node == "F")
+
+  stats->processed(accepted.size() + passed);
+  stats->duplicates(duplicates.size());
+
+  if (!accepted.empty())
   {
-    list = shared_data->seen_payloads_f;
-    count = &shared_data->count_f;
+    std::string lines;
+    for (int i : accepted)
+      lines += texts[i] + "\n";
+    data_log->append(std::move(lines));
+    if (stores_final_copy())
+    {
+      for (int i : accepted)
+        complete_trace(find_trace(traces, i));
+    }
   }
 
-  if (count && *count < MAX_PAYLOADS)
+  if (!duplicates.empty())
   {
-    strncpy(list[*count], payload.c_str(), MAX_PAYLOAD_LEN - 1);
-    list[*count][MAX_PAYLOAD_LEN - 1] = '\0';
-    (*count)++;
+    LOG_SAMPLED(LogLevel::Info, "[Node " << config.node_name << "] ⚠️ " << duplicates.size() << " duplicate payload(s). Skipping.");
+    std::string lines;
+    for (int i : duplicates)
+      lines += "[Node " + config.node_name + "] Duplicate: " + texts[i] + "\n";
+    duplicate_log->append(std::move(lines));
   }
+
+  return true;
+}
+
+// How long the sync service waits for a credit before rejecting a call.
+std::chrono::milliseconds queue_timeout()
+{
+  return credits ? credits->queue_timeout() : std::chrono::milliseconds(0);
+}
+
+// Grants upstream the records this node can still take, and passes on the
+// fingerprints queued for the summary.
+Status respond(grpc::ServerContextBase *context, const Status &status)
+{
+  if (admission)
+    grant_credits(*context, admission->credits());
+  if (seen_summary)
+    seen_summary->push(*context);
+  return status;
 }
 
 class ReceiverServiceImpl final : public DataService::Service
@@ -188,109 +594,174 @@ class ReceiverServiceImpl final : public DataService::Service
 public:
   Status SendData(ServerContext *context, const DataRequest *request, Empty *response) override
   {
-    std::string payload = request->payload();
-    std::cout << "[Node " << config.node_name << "] ✅ Received payload: " << payload << std::endl;
-
-    sem_wait(shared_mutex);
-    bool is_dup = is_duplicate(config.node_name, payload);
-    sem_post(shared_mutex);
+    Admitted admitted(admission.get(), 1);
+    if (!admitted.ok())
+      return respond(context, overloaded(config.node_name));
+
+    auto start = std::chrono::steady_clock::now();
+    TraceSet traces = arrive_traces(*context, trace_now_us());
+    TraceContext *trace = find_trace(traces, 0);
+    Status status = Status::OK;
+    std::string next_hop;
+    switch (accept_payload(payload_text(*request), next_hop, queue_timeout(), trace))
+    {
+    case Acceptance::Forward:
+      forward_sync(next_hop, *request, trace);
+      break;
+    case Acceptance::Overloaded:
+      status = overloaded(config.node_name);
+      break;
+    default:
+      break;
+    }
+    stats->observe_latency(std::chrono::steady_clock::now() - start);
+    return respond(context, status);
+  }
 
-    if (is_dup)
+  Status SendBatch(ServerContext *context, const DataBatch *batch, Empty *response) override
+  {
+    Admitted admitted(admission.get(), batch->records_size());
+    if (!admitted.ok())
+      return respond(context, overloaded(config.node_name));
+
+    auto start = std::chrono::steady_clock::now();
+    TraceSet traces = arrive_traces(*context, trace_now_us());
+    Status status = Status::OK;
+    std::vector<std::pair<int, std::string>> forwards;
+    if (accept_batch(*batch, traces, queue_timeout(), forwards))
+    {
+      for (const auto &[index, next_hop] : forwards)
+        forward_sync(next_hop, batch->records(index), find_trace(traces, index));
+    }
+    else
     {
-      duplicate_count++;
-      std::cout << "[Node " << config.node_name << "] ⚠️ Duplicate payload. Skipping.\n";
-      std::ofstream dup("duplicates.txt", std::ios::app);
-      dup << "[Node " << config.node_name << "] Duplicate: " << payload << "\n";
-      return Status::OK;
+      status = overloaded(config.node_name);
     }
+    stats->observe_latency(std::chrono::steady_clock::now() - start);
+    return respond(context, status);
+  }
+
+  Status GetStats(ServerContext *context, const Empty *request, NodeStats *response) override
+  {
+    stats->fill(response);
+    return Status::OK;
+  }
+};
 
-    sem_wait(shared_mutex);
-    mark_processed(config.node_name, payload);
-    sem_post(shared_mutex);
-    processed_count++;
+// Finishes an inbound RPC that was admitted with `records`, and records how
+// long it took end to end.
+void finish_call(grpc::CallbackServerContext *context, grpc::ServerUnaryReactor *reactor,
+                 std::chrono::steady_clock::time_point start, int records, const Status &status = Status::OK)
+{
+  stats->observe_latency(std::chrono::steady_clock::now() - start);
+  if (admission)
+    admission->done(records);
+  reactor->Finish(respond(context, status));
+}
+
+// Callback-API variant: the downstream forward is issued asynchronously and
+// the inbound RPC finishes from its completion, so no handler thread is held
+// while the next hop works. Handlers never wait for credits; without one the
+// call is rejected straight away.
+class AsyncReceiverServiceImpl final : public DataService::CallbackService
+{
+public:
+  grpc::ServerUnaryReactor *SendData(grpc::CallbackServerContext *context, const DataRequest *request, Empty *response) override
+  {
+    grpc::ServerUnaryReactor *reactor = context->DefaultReactor();
+    if (admission && !admission->admit(1))
+    {
+      reactor->Finish(respond(context, overloaded(config.node_name)));
+      return reactor;
+    }
 
-    std::ofstream out("node_" + config.node_name + "_data.txt", std::ios::app);
-    out << payload << "\n";
+    auto start = std::chrono::steady_clock::now();
+    TraceSet traces = arrive_traces(*context, trace_now_us());
+    TraceContext *trace = find_trace(traces, 0);
 
-    if (config.node_name != "E" && config.node_name != "F")
+    std::string next_hop;
+    Acceptance accepted = accept_payload(payload_text(*request), next_hop, std::chrono::milliseconds(0), trace);
+    if (accepted == Acceptance::Overloaded)
+    {
+      finish_call(context, reactor, start, 1, overloaded(config.node_name));
+      return reactor;
+    }
+    if (accepted != Acceptance::Forward)
     {
-      std::string selected_neighbor;
+      finish_call(context, reactor, start, 1);
+      return reactor;
+    }
 
-      sem_wait(shared_mutex);
-      if (shared_data->num_neighbors > 0)
-      {
-        if (strategy == LoadStrategy::RoundRobin)
-        {
-          selected_neighbor = shared_data->loads[rr_index % shared_data->num_neighbors].name;
-          rr_index = (rr_index + 1) % shared_data->num_neighbors;
-          std::cout << "[Node " << config.node_name << "] 🔄 Round Robin → " << selected_neighbor << std::endl;
-        }
-        else
-        {
-          int min_load = INT_MAX;
-          for (int i = 0; i < shared_data->num_neighbors; ++i)
-          {
-            if (shared_data->loads[i].load_count < min_load)
-            {
-              min_load = shared_data->loads[i].load_count;
-              selected_neighbor = shared_data->loads[i].name;
-            }
-          }
-          std::cout << "[Node " << config.node_name << "] ⚖️ Least Loaded → " << selected_neighbor << std::endl;
-        }
-      }
-      sem_post(shared_mutex);
+    forward_async(
+        next_hop, *request, [context, reactor, start]
+        { finish_call(context, reactor, start, 1); },
+        trace);
+    return reactor;
+  }
 
-      if (!selected_neighbor.empty())
-      {
-        std::string neighbor_address = config.address_map[selected_neighbor];
-        auto channel = grpc::CreateChannel(neighbor_address, grpc::InsecureChannelCredentials());
-        std::unique_ptr<DataService::Stub> stub = DataService::NewStub(channel);
+  grpc::ServerUnaryReactor *SendBatch(grpc::CallbackServerContext *context, const DataBatch *batch, Empty *response) override
+  {
+    grpc::ServerUnaryReactor *reactor = context->DefaultReactor();
+    int records = batch->records_size();
+    if (admission && !admission->admit(records))
+    {
+      reactor->Finish(respond(context, overloaded(config.node_name)));
+      return reactor;
+    }
 
-        DataRequest forward_request;
-        forward_request.set_payload(payload);
-        Empty forward_response;
-        grpc::ClientContext ctx;
+    auto start = std::chrono::steady_clock::now();
+    TraceSet traces = arrive_traces(*context, trace_now_us());
 
-        grpc::Status status = stub->SendData(&ctx, forward_request, &forward_response);
-        if (status.ok())
-        {
-          std::cout << "  → Forwarded to " << selected_neighbor << " (" << neighbor_address << ")" << std::endl;
-          forwarded_count++;
+    std::vector<std::pair<int, std::string>> forwards;
+    if (!accept_batch(*batch, traces, std::chrono::milliseconds(0), forwards))
+    {
+      finish_call(context, reactor, start, records, overloaded(config.node_name));
+      return reactor;
+    }
+    if (forwards.empty())
+    {
+      finish_call(context, reactor, start, records);
+      return reactor;
+    }
 
-          sem_wait(shared_mutex);
-          for (int i = 0; i < shared_data->num_neighbors; ++i)
+    // Finish once the last forwarded record has been acked downstream.
+    auto remaining = std::make_shared<std::atomic<int>>(static_cast<int>(forwards.size()));
+    for (const auto &[index, next_hop] : forwards)
+    {
+      forward_async(
+          next_hop, batch->records(index), [context, reactor, remaining, start, records]
           {
-            if (selected_neighbor == shared_data->loads[i].name)
-            {
-              shared_data->loads[i].load_count++;
-              break;
-            }
-          }
-          sem_post(shared_mutex);
-        }
-        else
-        {
-          std::cerr << "  ✖ Failed to forward to " << selected_neighbor << ": " << status.error_message() << std::endl;
-        }
-      }
+            if (remaining->fetch_sub(1) == 1)
+              finish_call(context, reactor, start, records); },
+          find_trace(traces, index));
     }
+    return reactor;
+  }
 
-    return Status::OK;
+  grpc::ServerUnaryReactor *GetStats(grpc::CallbackServerContext *context, const Empty *request, NodeStats *response) override
+  {
+    grpc::ServerUnaryReactor *reactor = context->DefaultReactor();
+    stats->fill(response);
+    reactor->Finish(Status::OK);
+    return reactor;
   }
 };
 
 void RunServer()
 {
   std::string server_address = "0.0.0.0:" + std::to_string(config.listen_port);
-  ReceiverServiceImpl service;
+  ReceiverServiceImpl sync_service;
+  AsyncReceiverServiceImpl async_service;
 
   ServerBuilder builder;
   builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
-  builder.RegisterService(&service);
+  if (server_mode == ServerMode::Async)
+    builder.RegisterService(&async_service);
+  else
+    builder.RegisterService(&sync_service);
 
   std::unique_ptr<Server> server = builder.BuildAndStart();
-  std::cout << "[Node " << config.node_name << "] 🚀 Listening on " << server_address << std::endl;
+  LOG_INFO("[Node " << config.node_name << "] 🚀 Listening on " << server_address << (server_mode == ServerMode::Async ? " (async)" : " (sync)"));
   server->Wait();
 }
 
@@ -298,34 +769,99 @@ int main(int argc, char **argv)
 {
   if (argc < 2)
   {
-    std::cerr << "Usage: " << argv[0] << " <node_name> [roundrobin|leastloaded]" << std::endl;
+    LOG_ERROR("Usage: " << argv[0] << " <node_name> [roundrobin|leastloaded|p2c|consistenthash] [sync|async]");
     return 1;
   }
 
   std::string node_name = argv[1];
   std::string strategy_arg = (argc >= 3) ? argv[2] : "leastloaded";
+  std::string mode_arg = (argc >= 4) ? argv[3] : "sync";
 
   if (strategy_arg == "roundrobin")
     strategy = LoadStrategy::RoundRobin;
   else if (strategy_arg == "leastloaded")
     strategy = LoadStrategy::LeastLoaded;
+  else if (strategy_arg == "p2c")
+    strategy = LoadStrategy::PowerOfTwo;
+  else if (strategy_arg == "consistenthash")
+    strategy = LoadStrategy::ConsistentHash;
   else
   {
-    std::cerr << "❌ Invalid strategy: " << strategy_arg << std::endl;
+    LOG_ERROR("❌ Invalid strategy: " << strategy_arg);
+    return 1;
+  }
+
+  if (mode_arg == "sync")
+    server_mode = ServerMode::Sync;
+  else if (mode_arg == "async")
+    server_mode = ServerMode::Async;
+  else
+  {
+    LOG_ERROR("❌ Invalid server mode: " << mode_arg);
     return 1;
   }
 
   try
   {
     config = load_config("routing.json", node_name);
-    std::cout << "[Node " << node_name << "] 🛠 Config loaded successfully.\n";
+    configure_logging(config.logging);
+    stats = std::make_unique<StatsRecorder>(config);
+    LOG_INFO("[Node " << node_name << "] 🛠 Config loaded successfully.");
+    channels = std::make_unique<ChannelRegistry>(config);
+    if (config.backpressure.enabled)
+    {
+      credits = std::make_unique<EdgeCredits>(config.neighbors, config.backpressure);
+      admission = std::make_unique<Admission>(config.backpressure);
+      stats->add_queue("admitted_records", []
+                       { return admission->held(); });
+      stats->add_queue("credits_in_flight", []
+                       { return credits->in_flight(); });
+      stats->add_queue("credit_waiters", []
+                       { return credits->waiting(); });
+      retries = std::make_unique<OverloadRetries>(
+          *credits, [](const std::string &next_hop, const DataRequest &record)
+          { forward_async(next_hop, record, [] {}); });
+      stats->add_queue("overload_retry_records", []
+                       { return retries->queued(); });
+    }
+    if (config.seen_summary.enabled)
+    {
+      seen_summary = std::make_unique<SeenSummary>(config.seen_summary, false);
+      stats->add_queue("seen_summary_queued", []
+                       { return seen_summary->queued(); });
+    }
+    if (config.batching.enabled && !config.neighbors.empty())
+    {
+      batcher = std::make_unique<BatchForwarder>(*channels, config.neighbors, config.batching,
+                                                 record_forward, credits.get(), seen_summary.get());
+      stats->add_queue("batch_buffered_records", []
+                       { return batcher->buffered(); });
+      stats->add_queue("batches_in_flight", []
+                       { return batcher->in_flight(); });
+    }
     setup_shared_memory();
+
+    // The duplicate log is diagnostic only; never hold an ack for its fsync.
+    StorageOptions duplicate_storage = config.storage;
+    if (duplicate_storage.durability == Durability::FsyncBeforeAck)
+      duplicate_storage.durability = Durability::Periodic;
+    data_log = std::make_unique<Appender>("node_" + node_name + "_data.txt", config.storage);
+    duplicate_log = std::make_unique<Appender>("duplicates.txt", duplicate_storage);
+    if (strategy == LoadStrategy::ConsistentHash)
+    {
+      if (config.placement.weights.empty())
+        throw std::runtime_error("consistenthash needs placement.weights in routing.json");
+      ring = std::make_unique<HashRing>(config.placement);
+      routes_to_owner = owner_routes(config);
+    }
+    if (config.tracing.enabled && stores_final_copy())
+      trace_log = std::make_unique<Appender>("trace_" + node_name + ".jsonl", StorageOptions{});
     server_start_time = std::chrono::steady_clock::now();
     signal(SIGINT, write_benchmark_and_exit);
   }
   catch (const std::exception &ex)
   {
-    std::cerr << "❌ Failed to load config: " << ex.what() << std::endl;
+    LOG_ERROR("❌ Failed to load config: " << ex.what());
     return 1;
   }
 
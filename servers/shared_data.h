@@ -1,36 +1,132 @@
 #pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <pthread.h>
 
 #define SHM_NAME "/shared_load"
-#define SEM_NAME "/shared_mutex"
 
 #define MAX_NEIGHBORS 4
 #define MAX_NAME_LEN 16
-#define MAX_PAYLOADS 2048
-#define MAX_PAYLOAD_LEN 1024
 
+// Default index size of each SeenSet generation; routing.json's
+// "shared_memory" block sets the real one. Fingerprints keep being recorded
+// after a generation's text arena runs out, so the index, not the arena,
+// bounds how many records a generation holds.
+#define SEEN_INDEX_BUCKETS (1 << 18)
+
+// Slot value for an index entry whose payload text was not stored.
+#define SEEN_NO_SLOT (-1)
+
+// log2(ns) buckets per lock histogram: bucket i counts [2^i, 2^(i+1)) ns.
+#define LOCK_HIST_BUCKETS 32
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+static_assert(std::atomic<int32_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+static_assert(std::atomic<int>::is_always_lock_free, "shared-memory atomics must be lock-free");
+
+// A slot's name is written before num_neighbors is bumped past it, so readers
+// that load num_neighbors (acquire) see complete names and can read counters
+// without any lock.
 struct SharedLoad
 {
   char name[MAX_NAME_LEN];
-  int load_count;
+  std::atomic<int> load_count;
+
+  // Current load for the p2c strategy: records handed to this neighbor and
+  // not yet acked, and an EWMA of its forward RPC latency (0 = no sample yet).
+  std::atomic<int> outstanding;
+  std::atomic<uint32_t> latency_ewma_us;
 };
 
-struct SharedData
+// Counters of one SeenSet generation.
+struct alignas(64) SeenGeneration
 {
-  SharedLoad loads[MAX_NEIGHBORS];
-  int num_neighbors;
+  std::atomic<uint64_t> prepared_for; // generation the slot was last cleared for
+  std::atomic<int32_t> entries;     // fingerprints recorded
+  std::atomic<int32_t> texts;       // of which with text in the arena
+  std::atomic<uint64_t> arena_used; // bytes handed out (may exceed arena_bytes)
+  std::atomic<int64_t> opened_ns;   // steady_clock time it became current
+};
+
+// One node's seen payloads over a sliding window of `generations`
+// generations. Each generation is a lock-free open-addressing index of 64-bit
+// fingerprints (0 = empty bucket) over a bump arena of payload texts used to
+// confirm a fingerprint match. Each arena entry is a uint16 length followed
+// by the bytes, packed back to back. slots(g)[i] is 0 until bucket i's text
+// is published, then holds its arena offset + 1, or SEEN_NO_SLOT once the
+// arena is full.
+//
+// New records go into generation `current`, which lives in slot
+// current % (generations + 1). It closes once half its buckets are taken or
+// it is generation_ns old; `current` then moves to the spare slot in one
+// step and the oldest generation drops out of the window. That slot is
+// cleared to become the next spare and then tagged with the generation it
+// is prepared for; current only moves into a spare with the right tag. The
+// generation headers and then each
+// slot's arrays follow the SeenSet in memory, sized when the segment is
+// created (see seen_set_bytes()).
+struct alignas(64) SeenSet
+{
+  uint32_t generations;    // searched by lookups
+  uint64_t buckets;        // per generation, power of two
+  uint64_t arena_bytes;    // per generation, < 2^31 so offsets fit a slot
+  int64_t generation_ns;   // 0 = generations close on fill only
+  uint64_t slot_bytes;     // one slot's arrays, 8-byte aligned
+  std::atomic<uint64_t> current;
+
+  uint32_t slot_count() const { return generations + 1; }
+  uint32_t slot_of(uint64_t generation) const { return static_cast<uint32_t>(generation % slot_count()); }
+
+  SeenGeneration &generation(uint32_t slot) { return reinterpret_cast<SeenGeneration *>(this + 1)[slot]; }
+  const SeenGeneration &generation(uint32_t slot) const { return reinterpret_cast<const SeenGeneration *>(this + 1)[slot]; }
+  char *slot_base(uint32_t slot) { return reinterpret_cast<char *>(reinterpret_cast<SeenGeneration *>(this + 1) + slot_count()) + slot * slot_bytes; }
+  const char *slot_base(uint32_t slot) const { return reinterpret_cast<const char *>(reinterpret_cast<const SeenGeneration *>(this + 1) + slot_count()) + slot * slot_bytes; }
 
-  // Per-node seen payload tracking
-  char seen_payloads_c[MAX_PAYLOADS][MAX_PAYLOAD_LEN];
-  int count_c;
+  std::atomic<uint64_t> *fingerprints(uint32_t slot) { return reinterpret_cast<std::atomic<uint64_t> *>(slot_base(slot)); }
+  const std::atomic<uint64_t> *fingerprints(uint32_t slot) const { return reinterpret_cast<const std::atomic<uint64_t> *>(slot_base(slot)); }
+  std::atomic<int32_t> *slots(uint32_t slot) { return reinterpret_cast<std::atomic<int32_t> *>(fingerprints(slot) + buckets); }
+  const std::atomic<int32_t> *slots(uint32_t slot) const { return reinterpret_cast<const std::atomic<int32_t> *>(fingerprints(slot) + buckets); }
+  char *arena(uint32_t slot) { return reinterpret_cast<char *>(slots(slot) + buckets); }
+  const char *arena(uint32_t slot) const { return reinterpret_cast<const char *>(slots(slot) + buckets); }
+};
+
+// Call sites that take a region's load_mutex, profiled when built with
+// MINI2_LOCK_PROFILE (see region_lock.h). Keep LOCK_SITE_NAMES in step.
+enum LockSite
+{
+  LOCK_SITE_LOAD_REGISTER, // add_load(): first-time neighbor registration
+  LOCK_SITE_INSPECT,       // inspect_shared_memory snapshot
+  LOCK_SITE_COUNT
+};
+
+static const char *const LOCK_SITE_NAMES[LOCK_SITE_COUNT] = {"load register", "inspect snapshot"};
+
+struct LockHistogram
+{
+  std::atomic<uint64_t> acquisitions;
+  std::atomic<uint64_t> wait_ns_total;
+  std::atomic<uint64_t> hold_ns_total;
+  std::atomic<uint64_t> wait_ns_max;
+  std::atomic<uint64_t> hold_ns_max;
+  std::atomic<uint64_t> wait_buckets[LOCK_HIST_BUCKETS];
+  std::atomic<uint64_t> hold_buckets[LOCK_HIST_BUCKETS];
+};
 
-  char seen_payloads_d[MAX_PAYLOADS][MAX_PAYLOAD_LEN];
-  int count_d;
+// One node's region of the host segment (see shm_segment.h): the load table
+// over its neighbors and, for nodes that dedup, its SeenSet. Regions share no
+// lock; the SeenSet needs none at all.
+struct SharedData
+{
+  SharedLoad loads[MAX_NEIGHBORS];
+  std::atomic<int> num_neighbors;
 
-  char seen_payloads_e[MAX_PAYLOADS][MAX_PAYLOAD_LEN];
-  int count_e;
+  // Robust and process-shared: serializes registering names in loads[].
+  pthread_mutex_t load_mutex;
+  LockHistogram lock_profile[LOCK_SITE_COUNT]; // all zero unless MINI2_LOCK_PROFILE
 
-  char seen_payloads_f[MAX_PAYLOADS][MAX_PAYLOAD_LEN];
-  int count_f;
+  uint64_t seen_offset; // from the start of this region; 0 = no SeenSet
 
-  char payload[MAX_PAYLOAD_LEN]; // Optional: most recent payload
-};
\ No newline at end of file
+  SeenSet *seen_set() { return seen_offset ? reinterpret_cast<SeenSet *>(reinterpret_cast<char *>(this) + seen_offset) : nullptr; }
+  const SeenSet *seen_set() const { return seen_offset ? reinterpret_cast<const SeenSet *>(reinterpret_cast<const char *>(this) + seen_offset) : nullptr; }
+};
@@ -0,0 +1,317 @@
+#include "shm_segment.h"
+#include "dedup.h"
+#include "logger.h"
+#include "region_lock.h"
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+  // How long an attaching node waits for the creator to finish the layout
+  // before taking the segment for stale.
+  constexpr auto kCreateTimeout = std::chrono::seconds(5);
+
+  struct PlannedRegion
+  {
+    const ShmRegionOptions *options;
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  struct Layout
+  {
+    std::vector<PlannedRegion> regions;
+    uint64_t hash;
+    uint64_t total_size;
+  };
+
+  size_t page_align(size_t bytes)
+  {
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return (bytes + page - 1) / page * page;
+  }
+
+  uint64_t index_buckets(int requested)
+  {
+    uint64_t buckets = 1;
+    while (buckets < static_cast<uint64_t>(requested))
+      buckets <<= 1;
+    return requested > 0 ? buckets : 0;
+  }
+
+  void mix(uint64_t &hash, uint64_t value)
+  {
+    for (int i = 0; i < 8; ++i)
+    {
+      hash ^= (value >> (8 * i)) & 0xff;
+      hash *= 1099511628211ULL;
+    }
+  }
+
+  Layout plan_layout(const RoutingConfig &config)
+  {
+    const auto &regions = config.shared_memory.regions;
+    if (regions.size() > MAX_REGIONS)
+    {
+      LOG_ERROR("❌ " << regions.size() << " nodes share this host; the segment holds at most " << MAX_REGIONS);
+      exit(1);
+    }
+
+    Layout layout;
+    layout.hash = 1469598103934665603ULL;
+    layout.total_size = page_align(sizeof(ShmHeader));
+    mix(layout.hash, SHM_LAYOUT_VERSION);
+    for (const auto &options : regions)
+    {
+      if (options.node.size() >= MAX_NAME_LEN)
+      {
+        LOG_ERROR("❌ Node name too long for the shared segment: " << options.node);
+        exit(1);
+      }
+      uint64_t size = page_align(region_bytes(options));
+      layout.regions.push_back({&options, layout.total_size, size});
+      for (char c : options.node)
+        mix(layout.hash, static_cast<unsigned char>(c));
+      mix(layout.hash, index_buckets(options.seen_buckets));
+      mix(layout.hash, static_cast<uint64_t>(options.arena_bytes));
+      mix(layout.hash, static_cast<uint64_t>(options.generations));
+      mix(layout.hash, static_cast<uint64_t>(options.window_ms));
+      layout.total_size += size;
+    }
+    return layout;
+  }
+
+  void *map_segment(int fd, size_t bytes)
+  {
+    void *memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED)
+    {
+      perror("mmap");
+      exit(1);
+    }
+    return memory;
+  }
+
+  bool alive(int32_t pid)
+  {
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+  }
+
+  bool has_live_owner(const ShmHeader &segment)
+  {
+    for (uint32_t i = 0; i < segment.region_count && i < MAX_REGIONS; ++i)
+    {
+      if (alive(segment.directory[i].owner_pid.load()))
+        return true;
+    }
+    return false;
+  }
+
+  ShmHeader *create_segment(int fd, const Layout &layout)
+  {
+    if (ftruncate(fd, layout.total_size) == -1)
+    {
+      perror("ftruncate");
+      exit(1);
+    }
+
+    auto *segment = new (map_segment(fd, layout.total_size)) ShmHeader; // ftruncate zeroed it
+    segment->magic = SHM_MAGIC;
+    segment->version = SHM_LAYOUT_VERSION;
+    segment->layout_hash = layout.hash;
+    segment->total_size = layout.total_size;
+    segment->region_count = static_cast<uint32_t>(layout.regions.size());
+    for (size_t i = 0; i < layout.regions.size(); ++i)
+    {
+      ShmRegion &entry = segment->directory[i];
+      strncpy(entry.node, layout.regions[i].options->node.c_str(), MAX_NAME_LEN - 1);
+      entry.offset = layout.regions[i].offset;
+      entry.size = layout.regions[i].size;
+      init_region(reinterpret_cast<char *>(segment) + entry.offset, *layout.regions[i].options);
+    }
+    return segment;
+  }
+
+  // Maps the header of an existing segment once its creator is done with it,
+  // or returns nullptr if that never happens (the creator died half-way).
+  ShmHeader *wait_for_header(int fd)
+  {
+    auto deadline = std::chrono::steady_clock::now() + kCreateTimeout;
+    ShmHeader *header = nullptr;
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+      struct stat st;
+      if (!header && fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(ShmHeader))
+        header = static_cast<ShmHeader *>(map_segment(fd, sizeof(ShmHeader)));
+      if (header && (header->ready.load(std::memory_order_acquire) ||
+                     (header->magic != 0 && header->magic != SHM_MAGIC)))
+        return header;
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (header)
+      munmap(header, sizeof(ShmHeader));
+    return nullptr;
+  }
+
+  void claim_region(ShmHeader &segment, const std::string &node)
+  {
+    int index = find_region(segment, node);
+    if (index < 0)
+    {
+      LOG_ERROR("❌ No region for node " << node << " in the shared segment");
+      exit(1);
+    }
+
+    int32_t previous = segment.directory[index].owner_pid.exchange(getpid());
+    if (previous != 0 && previous != getpid() && alive(previous))
+    {
+      LOG_WARN("⚠️ Node " << node << " was already attached by pid " << previous);
+      return;
+    }
+
+    // Records a dead predecessor had in flight will never come back, and a
+    // spare generation it was clearing is finished here.
+    SharedData *data = region_data(segment, index);
+    for (auto &load : data->loads)
+      load.outstanding.store(0, std::memory_order_relaxed);
+    if (SeenSet *seen = data->seen_set())
+      repair_seen_set(*seen);
+  }
+}
+
+int find_region(const ShmHeader &segment, const std::string &node)
+{
+  for (uint32_t i = 0; i < segment.region_count && i < MAX_REGIONS; ++i)
+  {
+    if (strncmp(segment.directory[i].node, node.c_str(), MAX_NAME_LEN) == 0)
+      return static_cast<int>(i);
+  }
+  return -1;
+}
+
+size_t region_bytes(const ShmRegionOptions &options)
+{
+  uint64_t buckets = index_buckets(options.seen_buckets);
+  if (buckets == 0)
+    return sizeof(SharedData);
+  return (sizeof(SharedData) + alignof(SeenSet) - 1) / alignof(SeenSet) * alignof(SeenSet) +
+         seen_set_bytes(buckets, static_cast<uint64_t>(options.arena_bytes), static_cast<uint32_t>(options.generations));
+}
+
+SharedData *init_region(void *memory, const ShmRegionOptions &options)
+{
+  auto *data = new (memory) SharedData;
+  init_region_mutex(data->load_mutex);
+  uint64_t buckets = index_buckets(options.seen_buckets);
+  if (buckets > 0)
+  {
+    data->seen_offset = (sizeof(SharedData) + alignof(SeenSet) - 1) / alignof(SeenSet) * alignof(SeenSet);
+    init_seen_set(reinterpret_cast<char *>(data) + data->seen_offset, buckets, static_cast<uint64_t>(options.arena_bytes),
+                  static_cast<uint32_t>(options.generations),
+                  static_cast<int64_t>(options.window_ms) * 1000000 / options.generations);
+  }
+  return data;
+}
+
+ShmHeader *attach_segment(const RoutingConfig &config)
+{
+  Layout layout = plan_layout(config);
+
+  for (int attempt = 0; attempt < 3; ++attempt)
+  {
+    int fd = shm_open(SHM_NAME, O_CREAT | O_EXCL | O_RDWR, 0666);
+    if (fd != -1)
+    {
+      ShmHeader *segment = create_segment(fd, layout);
+      close(fd);
+      claim_region(*segment, config.node_name);
+      segment->ready.store(1, std::memory_order_release);
+      LOG_INFO("[Node " << config.node_name << "] 🧠 Created shared segment: " << segment->region_count
+                        << " region(s), " << segment->total_size << " bytes");
+      return segment;
+    }
+    if (errno != EEXIST)
+    {
+      perror("shm_open");
+      exit(1);
+    }
+
+    fd = shm_open(SHM_NAME, O_RDWR, 0666);
+    if (fd == -1)
+    {
+      if (errno == ENOENT)
+        continue; // unlinked since
+      perror("shm_open");
+      exit(1);
+    }
+    struct stat st;
+    fstat(fd, &st);
+
+    ShmHeader *header = wait_for_header(fd);
+    bool ours = header && header->magic == SHM_MAGIC;
+    bool compatible = ours && header->version == SHM_LAYOUT_VERSION && header->layout_hash == layout.hash &&
+                      header->total_size == layout.total_size;
+    bool in_use = ours && has_live_owner(*header);
+    if (header)
+      munmap(header, sizeof(ShmHeader));
+
+    if (compatible && in_use)
+    {
+      auto *segment = static_cast<ShmHeader *>(map_segment(fd, layout.total_size));
+      close(fd);
+      claim_region(*segment, config.node_name);
+      LOG_INFO("[Node " << config.node_name << "] 🧠 Attached to shared segment: " << segment->region_count
+                        << " region(s), " << segment->total_size << " bytes");
+      return segment;
+    }
+    close(fd);
+    if (in_use)
+    {
+      LOG_ERROR("❌ Shared segment " << SHM_NAME << " is in use with a different layout than routing.json;"
+                                     << " stop the nodes attached to it first, or give nodes on one machine the same \"host\"");
+      exit(1);
+    }
+
+    // Left behind by an earlier run or a crash. Unlink it only if the name
+    // still refers to the segment we looked at.
+    LOG_WARN("[Node " << config.node_name << "] ♻️ Replacing stale shared segment " << SHM_NAME);
+    int current = shm_open(SHM_NAME, O_RDONLY, 0666);
+    if (current != -1)
+    {
+      struct stat now;
+      if (fstat(current, &now) == 0 && now.st_ino == st.st_ino)
+        shm_unlink(SHM_NAME);
+      close(current);
+    }
+  }
+
+  LOG_ERROR("❌ Could not create or attach to shared segment " << SHM_NAME);
+  exit(1);
+}
+
+void detach_segment(ShmHeader *segment, const std::string &node)
+{
+  int index = find_region(*segment, node);
+  if (index >= 0)
+  {
+    int32_t self = getpid();
+    segment->directory[index].owner_pid.compare_exchange_strong(self, 0);
+  }
+  if (!has_live_owner(*segment))
+  {
+    shm_unlink(SHM_NAME);
+  }
+  munmap(segment, segment->total_size);
+}
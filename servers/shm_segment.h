@@ -0,0 +1,62 @@
+#pragma once
+#include "config_loader.h"
+#include "shared_data.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// The host-wide SHM_NAME segment: a header, a directory with one entry per
+// node on this host, and each node's region (its SharedData and SeenSet) at a
+// page-aligned offset. Which nodes get a region, and how large, comes from
+// routing.json (see SharedMemoryOptions), so nodes can be added without
+// recompiling and a host only pays for the nodes it runs.
+//
+// The first node to start on a host creates the segment; later ones check
+// its version and layout hash and attach without touching their siblings'
+// regions. A segment left behind by processes that are all gone is stale and
+// is created afresh.
+
+#define SHM_MAGIC 0x6d696e6932736567ULL // "mini2seg"
+#define SHM_LAYOUT_VERSION 6
+#define MAX_REGIONS 16
+
+struct ShmRegion
+{
+  char node[MAX_NAME_LEN];
+  uint64_t offset; // from the start of the segment
+  uint64_t size;
+  std::atomic<int32_t> owner_pid; // process attached as this node; 0 = none
+};
+
+struct ShmHeader
+{
+  uint64_t magic;
+  uint32_t version;
+  uint32_t region_count;
+  uint64_t layout_hash; // of the directory as computed from routing.json
+  uint64_t total_size;
+  std::atomic<uint32_t> ready; // set once the creator has laid out every region
+  ShmRegion directory[MAX_REGIONS];
+};
+
+inline SharedData *region_data(ShmHeader &segment, int index)
+{
+  return reinterpret_cast<SharedData *>(reinterpret_cast<char *>(&segment) + segment.directory[index].offset);
+}
+
+// Directory index of node's region, or -1 if it has none on this host.
+int find_region(const ShmHeader &segment, const std::string &node);
+
+// Bytes a node's region takes, and laying one out in zeroed memory that size.
+size_t region_bytes(const ShmRegionOptions &options);
+SharedData *init_region(void *memory, const ShmRegionOptions &options);
+
+// Creates or attaches to this host's segment and claims the region of
+// config.node_name for this process. Exits on failure, like the other startup
+// syscalls.
+ShmHeader *attach_segment(const RoutingConfig &config);
+
+// Gives up node's region; the last process to leave unlinks the segment.
+void detach_segment(ShmHeader *segment, const std::string &node);
@@ -0,0 +1,141 @@
+#include "trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <sstream>
+
+void TraceContext::arrive(const std::string &node, int64_t arrive_us)
+{
+  hops.push_back({node, arrive_us, 0});
+}
+
+void TraceContext::depart()
+{
+  if (!hops.empty())
+    hops.back().depart_us = trace_now_us();
+}
+
+int64_t trace_now_us()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+bool start_trace(const TracingOptions &options, TraceContext &trace)
+{
+  static std::atomic<uint64_t> calls{0};
+  if (!options.enabled || calls.fetch_add(1, std::memory_order_relaxed) % options.sample_every != 0)
+    return false;
+
+  thread_local std::mt19937_64 rng(std::random_device{}());
+  char id[17];
+  snprintf(id, sizeof(id), "%016llx", static_cast<unsigned long long>(rng()));
+  trace.id = id;
+  trace.hops.clear();
+  return true;
+}
+
+// id;node,arrive,depart;node,arrive,depart...
+std::string encode_trace(const TraceContext &trace)
+{
+  std::string text = trace.id;
+  for (const auto &hop : trace.hops)
+  {
+    text += ';' + hop.node + ',' + std::to_string(hop.arrive_us) + ',' + std::to_string(hop.depart_us);
+  }
+  return text;
+}
+
+bool decode_trace(const std::string &text, TraceContext &trace)
+{
+  std::stringstream in(text);
+  std::string part;
+  if (!std::getline(in, trace.id, ';') || trace.id.empty())
+    return false;
+
+  trace.hops.clear();
+  while (std::getline(in, part, ';'))
+  {
+    size_t first = part.find(',');
+    size_t second = part.find(',', first + 1);
+    if (first == std::string::npos || second == std::string::npos)
+      return false;
+    try
+    {
+      trace.hops.push_back({part.substr(0, first), std::stoll(part.substr(first + 1, second - first - 1)),
+                            std::stoll(part.substr(second + 1))});
+    }
+    catch (const std::exception &)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Metadata value: index=trace|index=trace...
+void attach_traces(grpc::ClientContext &context, const TraceSet &traces)
+{
+  if (traces.empty())
+    return;
+  std::string value;
+  for (const auto &[index, trace] : traces)
+  {
+    if (!value.empty())
+      value += '|';
+    value += std::to_string(index) + '=' + encode_trace(trace);
+  }
+  context.AddMetadata(kTraceHeader, value);
+}
+
+TraceSet incoming_traces(const grpc::ServerContextBase &context)
+{
+  TraceSet traces;
+  auto range = context.client_metadata().equal_range(kTraceHeader);
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    std::stringstream in(std::string(it->second.data(), it->second.size()));
+    std::string entry;
+    while (std::getline(in, entry, '|'))
+    {
+      size_t eq = entry.find('=');
+      TraceContext trace;
+      if (eq == std::string::npos || !decode_trace(entry.substr(eq + 1), trace))
+        continue;
+      try
+      {
+        traces.emplace_back(std::stoi(entry.substr(0, eq)), std::move(trace));
+      }
+      catch (const std::exception &)
+      {
+      }
+    }
+  }
+  return traces;
+}
+
+TraceContext *find_trace(TraceSet &traces, int index)
+{
+  for (auto &[i, trace] : traces)
+  {
+    if (i == index)
+      return &trace;
+  }
+  return nullptr;
+}
+
+std::string trace_json(const TraceContext &trace)
+{
+  std::string line = "{\"id\":\"" + trace.id + "\",\"hops\":[";
+  for (size_t i = 0; i < trace.hops.size(); ++i)
+  {
+    const TraceHop &hop = trace.hops[i];
+    if (i > 0)
+      line += ',';
+    line += "[\"" + hop.node + "\"," + std::to_string(hop.arrive_us) + ',' + std::to_string(hop.depart_us) + ']';
+  }
+  return line + "]}";
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "config_loader.h"
+
+#include <grpcpp/grpcpp.h>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Sampled end-to-end tracing. Node A starts a trace for 1 in
+// tracing.sample_every records. Every hop appends its arrive/depart time, and
+// the trace travels in the x-mini2-trace metadata of each SendData/SendBatch
+// forward. Leaves append completed traces to trace_<node>.jsonl, which
+// tools/trace_waterfall turns into a per-hop breakdown. Times are wall-clock
+// microseconds, so hops on different hosts need synchronized clocks.
+
+constexpr char kTraceHeader[] = "x-mini2-trace";
+
+struct TraceHop
+{
+  std::string node;
+  int64_t arrive_us = 0;
+  int64_t depart_us = 0;
+};
+
+struct TraceContext
+{
+  std::string id;
+  std::vector<TraceHop> hops;
+
+  // Opens a hop for `node` arriving at `arrive_us`.
+  void arrive(const std::string &node, int64_t arrive_us);
+  // Closes the last hop now.
+  void depart();
+};
+
+// Traced records of one RPC, keyed by index in the batch (0 for SendData).
+using TraceSet = std::vector<std::pair<int, TraceContext>>;
+
+int64_t trace_now_us();
+
+// Starts a new trace for 1 in options.sample_every calls, or returns false.
+bool start_trace(const TracingOptions &options, TraceContext &trace);
+
+std::string encode_trace(const TraceContext &trace);
+bool decode_trace(const std::string &text, TraceContext &trace);
+
+void attach_traces(grpc::ClientContext &context, const TraceSet &traces);
+TraceSet incoming_traces(const grpc::ServerContextBase &context);
+
+// Trace for batch index `index`, or nullptr.
+TraceContext *find_trace(TraceSet &traces, int index);
+
+// One JSON line: {"id":"...","hops":[["A",arrive,depart],...]}
+std::string trace_json(const TraceContext &trace);
@@ -0,0 +1,108 @@
+#include "work_stealing_pool.h"
+
+namespace
+{
+  thread_local const WorkStealingPool *tls_pool = nullptr;
+  thread_local int tls_index = -1;
+}
+
+WorkStealingPool::WorkStealingPool(int threads)
+{
+  if (threads < 1)
+    threads = 1;
+  for (int i = 0; i < threads; ++i)
+    queues_.push_back(std::make_unique<Queue>());
+  for (int i = 0; i < threads; ++i)
+    threads_.emplace_back(&WorkStealingPool::run, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(idle_mu_);
+    stopping_ = true;
+  }
+  idle_cv_.notify_all();
+  for (auto &thread : threads_)
+    thread.join();
+}
+
+int WorkStealingPool::current_thread()
+{
+  return tls_index;
+}
+
+void WorkStealingPool::submit(Task task)
+{
+  int index = tls_pool == this ? tls_index : static_cast<int>(next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size());
+  {
+    std::lock_guard<std::mutex> lock(queues_[index]->mu);
+    queues_[index]->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(idle_mu_);
+    queued_++;
+  }
+  idle_cv_.notify_one();
+}
+
+int WorkStealingPool::queued()
+{
+  std::lock_guard<std::mutex> lock(idle_mu_);
+  return queued_ > 0 ? queued_ : 0; // briefly negative while a pop races a push
+}
+
+bool WorkStealingPool::pop_local(int index, Task &task)
+{
+  Queue &queue = *queues_[index];
+  std::lock_guard<std::mutex> lock(queue.mu);
+  if (queue.tasks.empty())
+    return false;
+  task = std::move(queue.tasks.back());
+  queue.tasks.pop_back();
+  return true;
+}
+
+bool WorkStealingPool::steal(int index, Task &task)
+{
+  int count = static_cast<int>(queues_.size());
+  for (int offset = 1; offset < count; ++offset)
+  {
+    Queue &victim = *queues_[(index + offset) % count];
+    std::unique_lock<std::mutex> lock(victim.mu, std::try_to_lock);
+    if (!lock.owns_lock() || victim.tasks.empty())
+      continue;
+    task = std::move(victim.tasks.front());
+    victim.tasks.pop_front();
+    return true;
+  }
+  return false;
+}
+
+void WorkStealingPool::run(int index)
+{
+  tls_pool = this;
+  tls_index = index;
+
+  while (true)
+  {
+    Task task;
+    if (pop_local(index, task) || steal(index, task))
+    {
+      {
+        std::lock_guard<std::mutex> lock(idle_mu_);
+        queued_--;
+      }
+      task();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(idle_mu_);
+    if (queued_ > 0)
+      continue; // a peer's deque was busy (try_lock) or a push is in flight
+    if (stopping_)
+      return;
+    idle_cv_.wait(lock, [this]
+                  { return stopping_ || queued_ > 0; });
+  }
+}
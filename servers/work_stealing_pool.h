@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads, each with its own task deque. A thread runs its own
+// newest task first and, when its deque is empty, steals the oldest task from
+// a peer, so one thread stuck on a slow call doesn't hold up queued work.
+class WorkStealingPool
+{
+public:
+  using Task = std::function<void()>;
+
+  explicit WorkStealingPool(int threads);
+  ~WorkStealingPool(); // runs every queued task, then joins
+
+  // Queues onto the caller's own deque from a pool thread, otherwise onto the
+  // next deque in rotation.
+  void submit(Task task);
+
+  int size() const { return static_cast<int>(threads_.size()); }
+
+  // Tasks submitted but not yet started.
+  int queued();
+
+  // Index of the calling pool thread, or -1 outside the pool.
+  static int current_thread();
+
+private:
+  struct Queue
+  {
+    std::mutex mu;
+    std::deque<Task> tasks;
+  };
+
+  void run(int index);
+  bool pop_local(int index, Task &task);
+  bool steal(int index, Task &task);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<unsigned> next_queue_{0};
+
+  std::mutex idle_mu_;
+  std::condition_variable idle_cv_;
+  int queued_ = 0; // guarded by idle_mu_
+  bool stopping_ = false;
+};
@@ -0,0 +1,186 @@
+#include "worker_ring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sched.h>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+namespace
+{
+  constexpr size_t kCapacity = WORKER_RING_BYTES;
+  constexpr uint64_t kMask = kCapacity - 1;
+
+  void copy_in(WorkerRing &ring, uint64_t pos, const void *src, size_t n)
+  {
+    size_t offset = pos & kMask;
+    size_t first = std::min(n, kCapacity - offset);
+    memcpy(ring.data + offset, src, first);
+    memcpy(ring.data, static_cast<const char *>(src) + first, n - first);
+  }
+
+  void copy_out(const WorkerRing &ring, uint64_t pos, void *dst, size_t n)
+  {
+    size_t offset = pos & kMask;
+    size_t first = std::min(n, kCapacity - offset);
+    memcpy(dst, ring.data + offset, first);
+    memcpy(static_cast<char *>(dst) + first, ring.data, n - first);
+  }
+
+  void ring_doorbell(WorkerRing &ring)
+  {
+    uint64_t one = 1;
+    ssize_t written;
+    do
+    {
+      written = write(ring.wake_write_fd, &one, sizeof(one));
+    } while (written < 0 && errno == EINTR);
+  }
+}
+
+WorkerRing *create_worker_ring()
+{
+  void *memory = mmap(nullptr, sizeof(WorkerRing), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED)
+  {
+    perror("mmap");
+    exit(1);
+  }
+
+  WorkerRing *ring = new (memory) WorkerRing();
+  ring->head.store(0);
+  ring->tail.store(0);
+  ring->idle.store(0);
+  ring->closed.store(0);
+
+#ifdef __linux__
+  int fd = eventfd(0, 0);
+  if (fd == -1)
+  {
+    perror("eventfd");
+    exit(1);
+  }
+  ring->wake_read_fd = fd;
+  ring->wake_write_fd = fd;
+#else
+  int pipefd[2];
+  if (pipe(pipefd) == -1)
+  {
+    perror("pipe");
+    exit(1);
+  }
+  ring->wake_read_fd = pipefd[0];
+  ring->wake_write_fd = pipefd[1];
+#endif
+  return ring;
+}
+
+void destroy_worker_ring(WorkerRing *ring)
+{
+  close(ring->wake_read_fd);
+  if (ring->wake_write_fd != ring->wake_read_fd)
+    close(ring->wake_write_fd);
+  munmap(ring, sizeof(WorkerRing));
+}
+
+bool ring_push(WorkerRing &ring, const void *record, uint32_t length)
+{
+  uint64_t needed = sizeof(length) + static_cast<uint64_t>(length);
+  if (needed > kCapacity)
+    return false;
+
+  uint64_t head = ring.head.load(std::memory_order_relaxed);
+  while (head + needed - ring.tail.load(std::memory_order_acquire) > kCapacity)
+  {
+    if (ring.closed.load(std::memory_order_relaxed))
+      return false;
+    sched_yield();
+  }
+
+  copy_in(ring, head, &length, sizeof(length));
+  copy_in(ring, head + sizeof(length), record, length);
+
+  // Publish, then check idle: paired with ring_wait(), which sets idle before
+  // re-reading head, so one side always sees the other.
+  ring.head.store(head + needed, std::memory_order_seq_cst);
+  if (ring.idle.load(std::memory_order_seq_cst) && ring.idle.exchange(0, std::memory_order_seq_cst))
+    ring_doorbell(ring);
+  return true;
+}
+
+size_t ring_drain(WorkerRing &ring, const std::function<void(const char *, uint32_t)> &handle)
+{
+  uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+  uint64_t head = ring.head.load(std::memory_order_acquire);
+  size_t records = 0;
+  std::string scratch;
+
+  while (tail < head)
+  {
+    uint32_t length;
+    copy_out(ring, tail, &length, sizeof(length));
+    uint64_t body = tail + sizeof(length);
+
+    size_t offset = body & kMask;
+    if (offset + length <= kCapacity)
+    {
+      handle(ring.data + offset, length);
+    }
+    else
+    {
+      scratch.resize(length);
+      copy_out(ring, body, &scratch[0], length);
+      handle(scratch.data(), length);
+    }
+
+    // Release each record as soon as it is handled: handlers forward over
+    // gRPC and can be slow, and the producer should not stall on the batch.
+    tail = body + length;
+    ring.tail.store(tail, std::memory_order_release);
+    records++;
+  }
+  return records;
+}
+
+bool ring_wait(WorkerRing &ring)
+{
+  while (true)
+  {
+    if (ring.tail.load(std::memory_order_relaxed) != ring.head.load(std::memory_order_acquire))
+      return true;
+    if (ring.closed.load(std::memory_order_acquire))
+      return false;
+
+    ring.idle.store(1, std::memory_order_seq_cst);
+    if (ring.tail.load(std::memory_order_relaxed) != ring.head.load(std::memory_order_seq_cst) ||
+        ring.closed.load(std::memory_order_seq_cst))
+    {
+      ring.idle.store(0, std::memory_order_relaxed);
+      continue;
+    }
+
+    uint64_t count;
+    ssize_t got = read(ring.wake_read_fd, &count, sizeof(count));
+    if (got < 0 && errno != EINTR)
+    {
+      perror("read");
+      return false;
+    }
+    ring.idle.store(0, std::memory_order_relaxed);
+  }
+}
+
+void ring_close(WorkerRing &ring)
+{
+  ring.closed.store(1, std::memory_order_seq_cst);
+  ring.idle.store(0, std::memory_order_seq_cst);
+  ring_doorbell(ring);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Single-producer/single-consumer byte ring shared between node B and one
+// worker process. Records are <uint32 length><bytes>, wrapping at the end of
+// the buffer. The producer only rings the doorbell (an eventfd, or a pipe
+// where eventfd is unavailable) when the consumer has said it is going idle,
+// so a busy worker costs no syscalls per record.
+
+// Ring capacity in bytes (power of two).
+#define WORKER_RING_BYTES (1 << 20)
+
+struct WorkerRing
+{
+  alignas(64) std::atomic<uint64_t> head; // bytes published by the producer
+  alignas(64) std::atomic<uint64_t> tail; // bytes released by the consumer
+  alignas(64) std::atomic<int> idle;      // consumer is (about to be) blocked
+  std::atomic<int> closed;
+
+  int wake_read_fd;
+  int wake_write_fd;
+
+  alignas(64) char data[WORKER_RING_BYTES];
+};
+
+// Maps a ring in memory that stays shared with children forked afterwards.
+WorkerRing *create_worker_ring();
+void destroy_worker_ring(WorkerRing *ring);
+
+// Copies one record in, waiting while the ring is full. Returns false if the
+// record can never fit or the ring is closed. Callers serialize pushes.
+bool ring_push(WorkerRing &ring, const void *record, uint32_t length);
+
+// Hands every record published so far to `handle` (one acquire of head per
+// batch), releasing each record's space once it returns. Returns the number of
+// records consumed.
+size_t ring_drain(WorkerRing &ring, const std::function<void(const char *, uint32_t)> &handle);
+
+// Blocks until the ring has data or is closed. Returns false once the ring is
+// closed and empty.
+bool ring_wait(WorkerRing &ring);
+
+// Wakes the consumer and makes ring_wait() return false after the last record.
+void ring_close(WorkerRing &ring);
@@ -0,0 +1,161 @@
+// Stress test for the windowed SeenSet (servers/dedup.cpp): no new record is
+// ever taken for a duplicate, recent records are remembered across
+// generation rotations, concurrent writers agree, and a dead writer or
+// clearer cannot stall lookups or stop the window. Exits non-zero on failure.
+#include "dedup.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  int failures = 0;
+
+  void check(bool ok, const char *what)
+  {
+    if (!ok)
+    {
+      std::fprintf(stderr, "FAIL: %s\n", what);
+      failures++;
+    }
+  }
+
+  struct Set
+  {
+    Set(uint64_t buckets, uint64_t arena_bytes, uint32_t generations, int64_t generation_ns = 0)
+        : memory(std::calloc(1, seen_set_bytes(buckets, arena_bytes, generations))),
+          seen(init_seen_set(memory, buckets, arena_bytes, generations, generation_ns))
+    {
+    }
+    ~Set() { std::free(memory); }
+
+    void *memory;
+    SeenSet *seen;
+  };
+
+  std::string key(const char *prefix, int i)
+  {
+    return prefix + std::to_string(i);
+  }
+
+  // Rotations of a small set: nothing is a false duplicate, and at least the
+  // documented window of (generations - 1) * buckets / 2 records is kept.
+  void window_retention()
+  {
+    const uint64_t buckets = 64;
+    const uint32_t generations = 3;
+    Set set(buckets, 4096, generations);
+    const int records = 1000;
+
+    for (int i = 0; i < records; ++i)
+      check(mark_processed(*set.seen, key("rec", i)), "new record taken for a duplicate");
+    check(set.seen->current.load() > generations, "window never rotated");
+
+    const int window = static_cast<int>((generations - 1) * buckets / 2);
+    for (int i = records - window; i < records; ++i)
+      check(is_duplicate(*set.seen, key("rec", i)), "record inside the window forgotten");
+    check(!is_duplicate(*set.seen, key("rec", 0)), "record far outside the window remembered");
+  }
+
+  // Writers racing over one set: every key is accepted exactly once.
+  void concurrent_writers()
+  {
+    Set set(1 << 16, 1 << 16, 4);
+    const int threads = 8;
+    const int keys = 400000;
+    std::atomic<int> accepted{0};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+      workers.emplace_back([&, t]
+                           {
+                             for (int i = t; i < keys; i += threads)
+                             {
+                               if (mark_processed(*set.seen, key("x", i)))
+                                 accepted++;
+                             } });
+    }
+    for (auto &worker : workers)
+      worker.join();
+    check(accepted.load() == keys, "concurrent writers dropped new records as duplicates");
+  }
+
+  // Generations also close on age.
+  void time_window()
+  {
+    Set set(1 << 10, 1 << 14, 2, 50 * 1000 * 1000LL);
+    mark_processed(*set.seen, "old");
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    mark_processed(*set.seen, "a");
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    mark_processed(*set.seen, "b");
+    check(!is_duplicate(*set.seen, "old"), "aged-out record remembered");
+    check(is_duplicate(*set.seen, "b"), "fresh record forgotten");
+  }
+
+  // A writer killed between claiming a bucket and publishing its text.
+  void dead_writer()
+  {
+    Set set(1 << 10, 1 << 14, 2);
+    const std::string payload = "orphan";
+    uint64_t fp = payload_fingerprint(payload);
+    uint32_t slot = set.seen->slot_of(set.seen->current.load());
+    set.seen->fingerprints(slot)[fp & (set.seen->buckets - 1)].store(fp);
+
+    auto start = std::chrono::steady_clock::now();
+    check(!is_duplicate(*set.seen, payload), "unpublished bucket taken as a match");
+    check(mark_processed(*set.seen, payload), "record behind an unpublished bucket dropped");
+    check(!mark_processed(*set.seen, payload), "record behind an unpublished bucket not recorded");
+    check(std::chrono::steady_clock::now() - start < std::chrono::seconds(1), "lookup stalled on a dead writer");
+  }
+
+  // A closer killed while clearing the spare: the window stops until the
+  // node's region is taken over and repair_seen_set() finishes the job.
+  void dead_clearer()
+  {
+    const uint64_t buckets = 64;
+    Set set(buckets, 4096, 3);
+    SeenSet &seen = *set.seen;
+    int next = 0;
+    while (seen.current.load() < 5)
+      mark_processed(seen, key("warm", next++));
+
+    uint64_t spare = seen.current.load() + 1;
+    SeenGeneration &generation = seen.generation(seen.slot_of(spare));
+    generation.prepared_for.store(spare - seen.slot_count());
+    generation.entries.store(7);
+    seen.fingerprints(seen.slot_of(spare))[0].store(12345);
+
+    uint64_t stuck = seen.current.load();
+    for (uint64_t i = 0; i < buckets; ++i)
+      mark_processed(seen, key("stuck", next++));
+    check(seen.current.load() == stuck, "window moved into a half-cleared spare");
+
+    repair_seen_set(seen);
+    check(generation.prepared_for.load() == spare && generation.entries.load() == 0 &&
+              seen.fingerprints(seen.slot_of(spare))[0].load() == 0,
+          "repair left the spare dirty");
+    for (uint64_t i = 0; i < buckets; ++i)
+      mark_processed(seen, key("moving", next++));
+    check(seen.current.load() > stuck, "window did not move after repair");
+  }
+}
+
+int main()
+{
+  window_retention();
+  concurrent_writers();
+  time_window();
+  dead_writer();
+  dead_clearer();
+  if (failures)
+    return 1;
+  std::printf("dedup_window_test: ok\n");
+  return 0;
+}
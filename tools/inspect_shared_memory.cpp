@@ -1,10 +1,61 @@
 #include "../servers/shared_data.h"
+#include "../servers/shm_segment.h"
+#include "../servers/region_lock.h"
 #include <iostream>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
 #include <cstring>
-#include <semaphore.h>
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+  // Upper bound (ns) of the bucket holding the q-th quantile of a histogram.
+  uint64_t quantile_ns(const std::atomic<uint64_t> *buckets, uint64_t samples, double q)
+  {
+    uint64_t target = static_cast<uint64_t>(q * samples);
+    uint64_t seen = 0;
+    for (int i = 0; i < LOCK_HIST_BUCKETS; ++i)
+    {
+      seen += buckets[i].load();
+      if (seen > target)
+        return uint64_t(2) << i;
+    }
+    return uint64_t(2) << (LOCK_HIST_BUCKETS - 1);
+  }
+
+  void print_lock_profile(const SharedData &region)
+  {
+    std::cout << "⏱ Lock profile (load_mutex):\n";
+    int bottleneck = -1;
+    uint64_t worst_wait = 0;
+    for (int site = 0; site < LOCK_SITE_COUNT; ++site)
+    {
+      const LockHistogram &h = region.lock_profile[site];
+      uint64_t n = h.acquisitions.load();
+      if (n == 0)
+        continue;
+
+      std::cout << "  - " << LOCK_SITE_NAMES[site] << ": " << n << " acquisitions\n"
+                << "      wait avg " << h.wait_ns_total.load() / n << " ns, p50 <" << quantile_ns(h.wait_buckets, n, 0.5)
+                << " ns, p99 <" << quantile_ns(h.wait_buckets, n, 0.99) << " ns, max " << h.wait_ns_max.load() << " ns\n"
+                << "      hold avg " << h.hold_ns_total.load() / n << " ns, p50 <" << quantile_ns(h.hold_buckets, n, 0.5)
+                << " ns, p99 <" << quantile_ns(h.hold_buckets, n, 0.99) << " ns, max " << h.hold_ns_max.load() << " ns\n";
+
+      if (h.wait_ns_total.load() >= worst_wait)
+      {
+        worst_wait = h.wait_ns_total.load();
+        bottleneck = site;
+      }
+    }
+
+    if (bottleneck < 0)
+      std::cout << "  (no samples: servers built without MINI2_LOCK_PROFILE?)\n";
+    else
+      std::cout << "  Most contended: " << LOCK_SITE_NAMES[bottleneck] << "\n";
+  }
+}
 
 int main()
 {
@@ -15,35 +66,70 @@ int main()
     return 1;
   }
 
-  void *addr = mmap(NULL, sizeof(SharedData), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  void *addr = mmap(NULL, sizeof(ShmHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
   if (addr == MAP_FAILED)
   {
     perror("mmap");
     return 1;
   }
+  auto *header = static_cast<ShmHeader *>(addr);
+  if (header->magic != SHM_MAGIC || header->version != SHM_LAYOUT_VERSION || !header->ready.load())
+  {
+    std::cerr << "❌ " << SHM_NAME << " is not a version " << SHM_LAYOUT_VERSION << " segment (or is still being created)\n";
+    return 1;
+  }
+  size_t total_size = header->total_size;
+  munmap(addr, sizeof(ShmHeader));
 
-  auto *segment = static_cast<SharedData *>(addr);
-
-  sem_t *mutex = sem_open(SEM_NAME, 0);
-  if (mutex == SEM_FAILED)
+  addr = mmap(NULL, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED)
   {
-    perror("sem_open");
+    perror("mmap");
     return 1;
   }
+  auto *segment = static_cast<ShmHeader *>(addr);
 
-  sem_wait(mutex);
+  std::cout << "🧠 Segment " << SHM_NAME << ": " << segment->region_count << " region(s), " << total_size << " bytes\n";
+  for (uint32_t r = 0; r < segment->region_count && r < MAX_REGIONS; ++r)
+  {
+    const ShmRegion &entry = segment->directory[r];
+    SharedData *region = region_data(*segment, static_cast<int>(r));
+    std::cout << "\n== Node " << entry.node << " (" << entry.size << " bytes, pid " << entry.owner_pid.load() << ")\n";
 
-  std::cout << "📊 Load Counts:\n";
-  std::cout << "num_neighbors = " << segment->num_neighbors << std::endl;
+    {
+      RegionLock lock(*region, LOCK_SITE_INSPECT);
 
-  for (int i = 0; i < segment->num_neighbors; ++i)
-  {
-    std::cout << "  - " << segment->loads[i].name << ": " << segment->loads[i].load_count << " messages\n";
-  }
+      std::cout << "📊 Load Counts:\n";
+      int num_neighbors = region->num_neighbors.load();
+      std::cout << "num_neighbors = " << num_neighbors << std::endl;
+
+      for (int i = 0; i < num_neighbors; ++i)
+      {
+        const SharedLoad &load = region->loads[i];
+        std::cout << "  - " << load.name << ": " << load.load_count.load() << " messages, "
+                  << load.outstanding.load() << " outstanding, latency EWMA " << load.latency_ewma_us.load() << " us\n";
+      }
+    }
 
-  sem_post(mutex);
+    // Seen-set counters are atomics; no lock needed.
+    if (const SeenSet *set = region->seen_set())
+    {
+      uint64_t current = set->current.load();
+      std::cout << "🧾 Seen payloads: generation " << current << ", window of " << set->generations << " × "
+                << set->buckets << " buckets, " << set->arena_bytes << " arena bytes\n";
+      for (uint64_t back = 0; back < set->generations && back <= current; ++back)
+      {
+        const SeenGeneration &generation = set->generation(set->slot_of(current - back));
+        std::cout << "  - generation " << current - back << ": " << generation.entries.load() << " fingerprints, "
+                  << generation.texts.load() << " payloads in "
+                  << std::min<uint64_t>(generation.arena_used.load(), set->arena_bytes) << " arena bytes\n";
+      }
+    }
+
+    print_lock_profile(*region);
+  }
 
-  munmap(addr, sizeof(SharedData));
+  munmap(addr, total_size);
   close(fd);
   return 0;
 }
@@ -0,0 +1,442 @@
+// Open-loop load generator for node A. Requests are issued on a fixed
+// schedule regardless of how fast A answers, and latency is measured from
+// each request's scheduled send time, so queueing delay is not hidden
+// (no coordinated omission). Results are printed as JSON.
+//
+//   loadgen [--target=host:port] [--rate=N] [--duration=S] [--mode=unary|stream]
+//           [--connections=N] [--streams=N] [--max-inflight=N]
+//           [--files=a.txt,b.txt | --synthetic] [--dup-ratio=0.1]
+//           [--payload-size=natural|fixed:N|uniform:MIN:MAX] [--seed=N] [--out=file.json]
+#include "data.grpc.pb.h"
+
+#include <grpcpp/grpcpp.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using dataservice::DataRequest;
+using dataservice::DataService;
+using dataservice::Empty;
+using dataservice::IngestSummary;
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+  struct Options
+  {
+    std::string target;
+    double rate = 1000;
+    double duration_s = 10;
+    std::string mode = "unary";
+    int connections = 1;
+    int streams = 1;
+    int max_inflight = 10000;
+    std::vector<std::string> files;
+    bool synthetic = false;
+    double dup_ratio = 0;
+    std::string payload_size = "natural";
+    unsigned seed = 1;
+    std::string out;
+  };
+
+  std::vector<std::string> split(const std::string &text, char sep)
+  {
+    std::vector<std::string> parts;
+    std::stringstream in(text);
+    std::string part;
+    while (std::getline(in, part, sep))
+      parts.push_back(part);
+    return parts;
+  }
+
+  Options parse_args(int argc, char **argv)
+  {
+    std::map<std::string, std::string> args;
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      if (arg.rfind("--", 0) != 0)
+        throw std::runtime_error("Unexpected argument: " + arg);
+      size_t eq = arg.find('=');
+      args[arg.substr(2, eq == std::string::npos ? std::string::npos : eq - 2)] =
+          eq == std::string::npos ? "1" : arg.substr(eq + 1);
+    }
+
+    Options options;
+    for (const auto &[key, value] : args)
+    {
+      if (key == "target")
+        options.target = value;
+      else if (key == "rate")
+        options.rate = std::stod(value);
+      else if (key == "duration")
+        options.duration_s = std::stod(value);
+      else if (key == "mode")
+        options.mode = value;
+      else if (key == "connections")
+        options.connections = std::max(1, std::stoi(value));
+      else if (key == "streams")
+        options.streams = std::max(1, std::stoi(value));
+      else if (key == "max-inflight")
+        options.max_inflight = std::max(1, std::stoi(value));
+      else if (key == "files")
+        options.files = split(value, ',');
+      else if (key == "synthetic")
+        options.synthetic = true;
+      else if (key == "dup-ratio")
+        options.dup_ratio = std::clamp(std::stod(value), 0.0, 1.0);
+      else if (key == "payload-size")
+        options.payload_size = value;
+      else if (key == "seed")
+        options.seed = static_cast<unsigned>(std::stoul(value));
+      else if (key == "out")
+        options.out = value;
+      else
+        throw std::runtime_error("Unknown option: --" + key);
+    }
+
+    if (options.mode != "unary" && options.mode != "stream")
+      throw std::runtime_error("Unknown mode: " + options.mode);
+    if (options.rate <= 0 || options.duration_s <= 0)
+      throw std::runtime_error("--rate and --duration must be positive");
+
+    if (options.target.empty())
+    {
+      std::ifstream in("routing.json");
+      if (!in.is_open())
+        throw std::runtime_error("No --target and no routing.json to read node A's address from");
+      json config;
+      in >> config;
+      options.target = config["address_map"]["A"].get<std::string>();
+    }
+    if (options.files.empty() && !options.synthetic)
+      options.files = {"clients/client1_data.txt", "clients/client2_data.txt", "clients/client3_data.txt"};
+    return options;
+  }
+
+  // Earlier payloads kept for --dup-ratio repeats: a uniform reservoir sample
+  // of everything sent, so memory stays fixed however long the run.
+  constexpr size_t kDupReservoir = 4096;
+
+  // Produces the payload for each scheduled request: file lines or synthetic
+  // collision records, optionally resized, with dup_ratio of them repeating
+  // an earlier payload.
+  class PayloadSource
+  {
+  public:
+    explicit PayloadSource(const Options &options) : options_(options), rng_(options.seed)
+    {
+      for (const auto &file : options.files)
+      {
+        std::ifstream in(file);
+        if (!in.is_open())
+          throw std::runtime_error("Failed to open " + file);
+        std::string line;
+        while (std::getline(in, line))
+        {
+          if (!line.empty())
+            lines_.push_back(line);
+        }
+      }
+      if (!options.synthetic && lines_.empty())
+        throw std::runtime_error("No records in input files");
+
+      std::vector<std::string> size = split(options.payload_size, ':');
+      if (size[0] == "fixed" && size.size() == 2)
+        min_size_ = max_size_ = std::stoul(size[1]);
+      else if (size[0] == "uniform" && size.size() == 3)
+      {
+        min_size_ = std::stoul(size[1]);
+        max_size_ = std::stoul(size[2]);
+      }
+      else if (size[0] != "natural")
+        throw std::runtime_error("Bad --payload-size: " + options.payload_size);
+    }
+
+    std::string next(uint64_t seq)
+    {
+      std::string payload;
+      if (!sent_.empty() && std::uniform_real_distribution<double>(0, 1)(rng_) < options_.dup_ratio)
+      {
+        payload = sent_[std::uniform_int_distribution<size_t>(0, sent_.size() - 1)(rng_)];
+        duplicates_++;
+        return payload;
+      }
+
+      payload = options_.synthetic ? synthetic(seq) : lines_[seq % lines_.size()];
+      resize(payload, seq);
+      remember(payload);
+      return payload;
+    }
+
+    uint64_t duplicates() const { return duplicates_; }
+
+  private:
+    void remember(const std::string &payload)
+    {
+      if (options_.dup_ratio <= 0)
+        return;
+      unique_sent_++;
+      if (sent_.size() < kDupReservoir)
+        sent_.push_back(payload);
+      else
+      {
+        uint64_t slot = std::uniform_int_distribution<uint64_t>(0, unique_sent_ - 1)(rng_);
+        if (slot < kDupReservoir)
+          sent_[slot] = payload;
+      }
+    }
+
+    // A collision-shaped CSV line; the coordinates encode seq so every
+    // synthetic record is distinct.
+    std::string synthetic(uint64_t seq)
+    {
+      static const char *const boroughs[] = {"BRONX", "BROOKLYN", "MANHATTAN", "QUEENS", "STATEN ISLAND"};
+      static const char *const factors[] = {"Unspecified", "Driver Inattention/Distraction", "Following Too Closely"};
+      static const char *const vehicles[] = {"Sedan", "Station Wagon/Sport Utility Vehicle", "Taxi", "Bus"};
+      std::uniform_int_distribution<int> pick(0, 1 << 30);
+
+      char buf[256];
+      snprintf(buf, sizeof(buf), "%02d/%02d/%04d,%d:%02d,%s,%05d,%.4f,%.4f,%d,0,0,0,0,0,0,0,0,%s,%s,%s,%s",
+               pick(rng_) % 12 + 1, pick(rng_) % 28 + 1, 2020 + pick(rng_) % 5, pick(rng_) % 24, pick(rng_) % 60,
+               boroughs[pick(rng_) % 5], 10000 + pick(rng_) % 1500,
+               40.0 + (seq % 10000) / 1e4, -73.0 - (seq / 10000 % 10000) / 1e4, pick(rng_) % 3,
+               factors[pick(rng_) % 3], factors[pick(rng_) % 3], vehicles[pick(rng_) % 4], vehicles[pick(rng_) % 4]);
+      return buf;
+    }
+
+    void resize(std::string &payload, uint64_t seq)
+    {
+      if (max_size_ == 0)
+        return;
+      size_t size = std::uniform_int_distribution<size_t>(min_size_, max_size_)(rng_);
+      if (payload.size() > size)
+      {
+        payload.resize(size);
+        payload += "#" + std::to_string(seq); // keep truncated payloads distinct
+      }
+      else
+      {
+        payload.append(size - payload.size(), 'x');
+      }
+    }
+
+    const Options &options_;
+    std::mt19937_64 rng_;
+    std::vector<std::string> lines_;
+    std::vector<std::string> sent_; // reservoir, at most kDupReservoir
+    uint64_t unique_sent_ = 0;
+    size_t min_size_ = 0;
+    size_t max_size_ = 0;
+    uint64_t duplicates_ = 0;
+  };
+
+  // One slot per scheduled request; written once by whichever thread
+  // completes it.
+  struct Results
+  {
+    explicit Results(size_t total) : latency_us(total, 0) {}
+
+    void record(uint64_t seq, Clock::time_point scheduled, bool ok)
+    {
+      latency_us[seq] = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - scheduled).count();
+      (ok ? succeeded : failed).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::vector<int64_t> latency_us;
+    std::atomic<uint64_t> succeeded{0};
+    std::atomic<uint64_t> failed{0};
+  };
+
+  std::vector<std::shared_ptr<grpc::Channel>> make_channels(const Options &options)
+  {
+    std::vector<std::shared_ptr<grpc::Channel>> channels;
+    for (int i = 0; i < options.connections; ++i)
+    {
+      grpc::ChannelArguments args;
+      args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1); // one TCP connection per channel
+      args.SetInt("mini2.loadgen_connection", i);
+      channels.push_back(grpc::CreateCustomChannel(options.target, grpc::InsecureChannelCredentials(), args));
+    }
+    return channels;
+  }
+
+  // Fires SendData calls on schedule from one thread; completions arrive on
+  // gRPC's callback threads. Waits only if max_inflight calls are pending,
+  // and even then latency is charged from the original schedule.
+  void run_unary(const Options &options, PayloadSource &source, Results &results, size_t total)
+  {
+    auto channels = make_channels(options);
+    std::vector<std::unique_ptr<DataService::Stub>> stubs;
+    for (auto &channel : channels)
+      stubs.push_back(DataService::NewStub(channel));
+
+    struct Call
+    {
+      grpc::ClientContext context;
+      DataRequest request;
+      Empty response;
+    };
+
+    std::mutex mu;
+    std::condition_variable cv;
+    int inflight = 0;
+
+    auto interval = std::chrono::duration<double>(1.0 / options.rate);
+    auto start = Clock::now();
+    for (size_t seq = 0; seq < total; ++seq)
+    {
+      auto scheduled = start + std::chrono::duration_cast<Clock::duration>(interval * static_cast<double>(seq));
+      auto *call = new Call;
+      call->request.set_payload(source.next(seq));
+      std::this_thread::sleep_until(scheduled);
+
+      {
+        std::unique_lock<std::mutex> lock(mu);
+        cv.wait(lock, [&]
+                { return inflight < options.max_inflight; });
+        inflight++;
+      }
+
+      stubs[seq % stubs.size()]->async()->SendData(&call->context, &call->request, &call->response,
+                                                   [&, call, seq, scheduled](grpc::Status status)
+                                                   {
+                                                     results.record(seq, scheduled, status.ok());
+                                                     delete call;
+                                                     std::lock_guard<std::mutex> lock(mu);
+                                                     inflight--;
+                                                     cv.notify_all();
+                                                   });
+    }
+
+    std::unique_lock<std::mutex> lock(mu);
+    cv.wait(lock, [&]
+            { return inflight == 0; });
+  }
+
+  // Spreads the schedule over `streams` StreamData calls (round robin over
+  // connections). A record's latency runs from its scheduled time until its
+  // Write() returns, which includes any HTTP/2 flow-control backpressure.
+  void run_stream(const Options &options, PayloadSource &source, Results &results, size_t total)
+  {
+    auto channels = make_channels(options);
+    std::vector<std::string> payloads(total);
+    for (size_t seq = 0; seq < total; ++seq)
+      payloads[seq] = source.next(seq);
+
+    auto interval = std::chrono::duration<double>(1.0 / options.rate);
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int s = 0; s < options.streams; ++s)
+    {
+      threads.emplace_back([&, s]
+                           {
+        auto stub = DataService::NewStub(channels[s % channels.size()]);
+        grpc::ClientContext context;
+        IngestSummary summary;
+        auto writer = stub->StreamData(&context, &summary);
+
+        DataRequest request;
+        for (size_t seq = s; seq < total; seq += options.streams)
+        {
+          auto scheduled = start + std::chrono::duration_cast<Clock::duration>(interval * static_cast<double>(seq));
+          std::this_thread::sleep_until(scheduled);
+          request.set_payload(payloads[seq]);
+          results.record(seq, scheduled, writer->Write(request));
+        }
+        writer->WritesDone();
+        grpc::Status status = writer->Finish();
+        if (!status.ok())
+          std::cerr << "Stream " << s << " failed: " << status.error_message() << std::endl; });
+    }
+    for (auto &thread : threads)
+      thread.join();
+  }
+
+  int64_t percentile(const std::vector<int64_t> &sorted, double q)
+  {
+    if (sorted.empty())
+      return 0;
+    size_t rank = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+  }
+}
+
+int main(int argc, char **argv)
+{
+  Options options;
+  try
+  {
+    options = parse_args(argc, argv);
+  }
+  catch (const std::exception &ex)
+  {
+    std::cerr << "loadgen: " << ex.what() << std::endl;
+    return 1;
+  }
+
+  size_t total = static_cast<size_t>(options.rate * options.duration_s);
+  PayloadSource source(options);
+  Results results(total);
+
+  auto started = Clock::now();
+  if (options.mode == "unary")
+    run_unary(options, source, results, total);
+  else
+    run_stream(options, source, results, total);
+  double elapsed_s = std::chrono::duration<double>(Clock::now() - started).count();
+
+  std::vector<int64_t> sorted = results.latency_us;
+  std::sort(sorted.begin(), sorted.end());
+  double mean = 0;
+  for (int64_t us : sorted)
+    mean += us;
+  mean = sorted.empty() ? 0 : mean / sorted.size();
+
+  json report = {
+      {"target", options.target},
+      {"mode", options.mode},
+      {"connections", options.connections},
+      {"streams", options.mode == "stream" ? options.streams : 0},
+      {"target_rps", options.rate},
+      {"duration_s", options.duration_s},
+      {"sent", total},
+      {"duplicates_sent", source.duplicates()},
+      {"succeeded", results.succeeded.load()},
+      {"failed", results.failed.load()},
+      {"elapsed_s", elapsed_s},
+      {"achieved_rps", elapsed_s > 0 ? results.succeeded.load() / elapsed_s : 0.0},
+      {"latency_us",
+       {{"mean", mean},
+        {"p50", percentile(sorted, 0.50)},
+        {"p90", percentile(sorted, 0.90)},
+        {"p99", percentile(sorted, 0.99)},
+        {"p999", percentile(sorted, 0.999)},
+        {"max", sorted.empty() ? 0 : sorted.back()}}}};
+
+  if (options.out.empty())
+  {
+    std::cout << report.dump(2) << std::endl;
+  }
+  else
+  {
+    std::ofstream out(options.out);
+    out << report.dump(2) << "\n";
+  }
+  return results.failed.load() == 0 ? 0 : 2;
+}
@@ -0,0 +1,145 @@
+// Polls GetStats on every node in routing.json and prints a live rate view.
+//
+//   stats_cli [interval_ms] [iterations]     (0 iterations = until Ctrl-C)
+#include "data.grpc.pb.h"
+
+#include <grpcpp/grpcpp.h>
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using dataservice::DataService;
+using dataservice::Empty;
+using dataservice::NodeStats;
+using json = nlohmann::json;
+
+namespace
+{
+  struct Node
+  {
+    std::string name;
+    std::string address;
+    std::unique_ptr<DataService::Stub> stub;
+    bool have_previous = false;
+    NodeStats previous;
+  };
+
+  double rate(uint64_t now, uint64_t before, double seconds)
+  {
+    return seconds > 0 ? (now - before) / seconds : 0.0;
+  }
+
+  // "C 51% D 49%" from per-neighbor forward counts over the last interval.
+  std::string balance(const NodeStats &now, const NodeStats *before)
+  {
+    std::map<std::string, uint64_t> deltas;
+    uint64_t total = 0;
+    for (const auto &neighbor : now.neighbors())
+    {
+      uint64_t previous = 0;
+      if (before)
+      {
+        for (const auto &old : before->neighbors())
+          if (old.neighbor() == neighbor.neighbor())
+            previous = old.forwarded();
+      }
+      deltas[neighbor.neighbor()] = neighbor.forwarded() - previous;
+      total += neighbor.forwarded() - previous;
+    }
+
+    std::ostringstream out;
+    for (const auto &[neighbor, delta] : deltas)
+    {
+      out << neighbor << " " << (total ? delta * 100 / total : 0) << "% ";
+    }
+    return out.str();
+  }
+}
+
+int main(int argc, char **argv)
+{
+  int interval_ms = argc > 1 ? std::stoi(argv[1]) : 1000;
+  int iterations = argc > 2 ? std::stoi(argv[2]) : 0;
+
+  std::ifstream in("routing.json");
+  if (!in.is_open())
+  {
+    std::cerr << "Failed to open routing.json" << std::endl;
+    return 1;
+  }
+  json config;
+  in >> config;
+
+  std::vector<Node> nodes;
+  for (auto &[name, address] : config["address_map"].items())
+  {
+    Node node;
+    node.name = name;
+    node.address = address.get<std::string>();
+    node.stub = DataService::NewStub(grpc::CreateChannel(node.address, grpc::InsecureChannelCredentials()));
+    nodes.push_back(std::move(node));
+  }
+
+  auto previous_poll = std::chrono::steady_clock::now();
+  for (int round = 0; iterations == 0 || round < iterations; ++round)
+  {
+    if (round > 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - previous_poll).count();
+    previous_poll = now;
+
+    std::cout << "\n"
+              << std::left << std::setw(6) << "node" << std::right
+              << std::setw(10) << "recv/s" << std::setw(10) << "proc/s" << std::setw(10) << "fwd/s"
+              << std::setw(10) << "dups" << std::setw(8) << "fail" << std::setw(9) << "p50us"
+              << std::setw(9) << "p99us" << "  balance | queues\n";
+
+    double tree_rate = 0;
+    for (auto &node : nodes)
+    {
+      NodeStats stats;
+      grpc::ClientContext context;
+      context.set_deadline(std::chrono::system_clock::now() + std::chrono::milliseconds(500));
+      grpc::Status status = node.stub->GetStats(&context, Empty(), &stats);
+      if (!status.ok())
+      {
+        std::cout << std::left << std::setw(6) << node.name << std::right << "  unreachable (" << node.address
+                  << "): " << status.error_message() << "\n";
+        node.have_previous = false;
+        continue;
+      }
+
+      const NodeStats *before = node.have_previous ? &node.previous : nullptr;
+      double received = before ? rate(stats.received(), before->received(), seconds) : 0;
+      double processed = before ? rate(stats.processed(), before->processed(), seconds) : 0;
+      double forwarded = before ? rate(stats.forwarded(), before->forwarded(), seconds) : 0;
+      if (stats.neighbors_size() == 0)
+        tree_rate += processed; // leaves: records that reached the end of the tree
+
+      std::cout << std::left << std::setw(6) << node.name << std::right << std::fixed << std::setprecision(0)
+                << std::setw(10) << received << std::setw(10) << processed << std::setw(10) << forwarded
+                << std::setw(10) << stats.duplicates() << std::setw(8) << stats.failed()
+                << std::setw(9) << stats.latency().p50_us() << std::setw(9) << stats.latency().p99_us()
+                << "  " << balance(stats, before) << "|";
+      for (const auto &queue : stats.queues())
+        std::cout << " " << queue.name() << "=" << queue.depth();
+      std::cout << "\n";
+
+      node.previous = stats;
+      node.have_previous = true;
+    }
+    std::cout << "tree: " << std::fixed << std::setprecision(0) << tree_rate << " records/s stored at leaves\n";
+    std::cout.flush();
+  }
+  return 0;
+}
@@ -0,0 +1,146 @@
+// Aggregates sampled traces written by the leaves into a per-hop waterfall.
+//
+//   trace_waterfall trace_E.jsonl [trace_F.jsonl ...]
+//
+// Each hop contributes a "<node> service" segment (arrive to depart), and each
+// pair of consecutive hops a "<from> → <to>" transit segment (depart of one to
+// arrive at the next: serialization, network and queueing before the handler).
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace
+{
+  struct Segment
+  {
+    int order = 0; // position of the first occurrence along a path
+    std::vector<int64_t> samples_us;
+  };
+
+  double percentile(std::vector<int64_t> &sorted, double p)
+  {
+    if (sorted.empty())
+      return 0.0;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return static_cast<double>(sorted[std::min(index, sorted.size() - 1)]);
+  }
+
+  // Pads to `width` columns; "→" is three bytes but one column.
+  std::string pad(const std::string &text, size_t width)
+  {
+    size_t columns = 0;
+    for (unsigned char c : text)
+      columns += (c & 0xC0) != 0x80;
+    return text + std::string(width > columns ? width - columns : 0, ' ');
+  }
+
+  void add_sample(std::map<std::string, Segment> &segments, const std::string &name, int order, int64_t us)
+  {
+    auto [it, inserted] = segments.try_emplace(name);
+    if (inserted)
+      it->second.order = order;
+    it->second.order = std::min(it->second.order, order);
+    it->second.samples_us.push_back(std::max<int64_t>(us, 0));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <trace_X.jsonl>..." << std::endl;
+    return 1;
+  }
+
+  std::map<std::string, Segment> segments;
+  std::vector<int64_t> end_to_end;
+
+  for (int f = 1; f < argc; ++f)
+  {
+    std::ifstream in(argv[f]);
+    if (!in)
+    {
+      std::cerr << "❌ Cannot open " << argv[f] << std::endl;
+      return 1;
+    }
+
+    std::string line;
+    while (std::getline(in, line))
+    {
+      if (line.empty())
+        continue;
+      json trace = json::parse(line, nullptr, false);
+      if (trace.is_discarded() || !trace.contains("hops"))
+        continue;
+
+      const json &hops = trace["hops"];
+      for (size_t i = 0; i < hops.size(); ++i)
+      {
+        std::string node = hops[i][0];
+        int64_t arrive = hops[i][1];
+        int64_t depart = hops[i][2];
+        if (i > 0)
+        {
+          std::string previous = hops[i - 1][0];
+          int64_t previous_depart = hops[i - 1][2];
+          add_sample(segments, previous + " → " + node, static_cast<int>(2 * i - 1), arrive - previous_depart);
+        }
+        add_sample(segments, node + " service", static_cast<int>(2 * i), depart - arrive);
+      }
+      if (!hops.empty())
+        end_to_end.push_back(static_cast<int64_t>(hops.back()[2]) - static_cast<int64_t>(hops.front()[1]));
+    }
+  }
+
+  if (end_to_end.empty())
+  {
+    std::cout << "No traces found." << std::endl;
+    return 0;
+  }
+
+  std::vector<std::pair<std::string, Segment *>> ordered;
+  for (auto &[name, segment] : segments)
+    ordered.emplace_back(name, &segment);
+  std::stable_sort(ordered.begin(), ordered.end(), [](const auto &a, const auto &b)
+                   { return a.second->order < b.second->order; });
+
+  // Bars are scaled to the largest mean so the slowest segment spans the width.
+  double widest = 0.0;
+  for (auto &[name, segment] : ordered)
+  {
+    double sum = 0.0;
+    for (int64_t us : segment->samples_us)
+      sum += us;
+    widest = std::max(widest, sum / segment->samples_us.size());
+  }
+  const int kBarWidth = 40;
+
+  std::sort(end_to_end.begin(), end_to_end.end());
+  std::printf("📊 %zu traces, end-to-end p50 %.0f us, p99 %.0f us\n\n", end_to_end.size(),
+              percentile(end_to_end, 0.50), percentile(end_to_end, 0.99));
+  std::printf("%-22s %8s %10s %10s %10s\n", "segment", "count", "mean(us)", "p50(us)", "p99(us)");
+
+  for (auto &[name, segment] : ordered)
+  {
+    std::vector<int64_t> &samples = segment->samples_us;
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (int64_t us : samples)
+      sum += us;
+    double mean = sum / samples.size();
+    int bar = widest > 0 ? static_cast<int>(mean / widest * kBarWidth + 0.5) : 0;
+
+    std::printf("%s %8zu %10.0f %10.0f %10.0f  %s\n", pad(name, 22).c_str(), samples.size(), mean,
+                percentile(samples, 0.50), percentile(samples, 0.99), std::string(bar, '#').c_str());
+  }
+  return 0;
+}